@@ -0,0 +1,421 @@
+#include <Helena/Helena.hpp>
+
+#include <fmt/format.h>
+
+namespace Benchmark
+{
+    // The result is accumulated in the global variable so that the compiler can't drop the listeners
+    inline std::uint64_t Counter {};
+
+    template <std::size_t Listeners>
+    struct Event {
+        std::uint64_t value;
+    };
+
+    template <std::size_t Listeners, std::size_t Index>
+    void OnEvent(const Event<Listeners> event) {
+        Counter += event.value + Index;
+    }
+
+    template <typename Func>
+    [[nodiscard]] double Measure(std::size_t iterations, Func&& func)
+    {
+        const auto timeStart = Helena::Types::Clock::Now();
+        for(std::size_t i = 0; i < iterations; ++i) {
+            func(i);
+        }
+        const auto timeEnd = Helena::Types::Clock::Now();
+        return static_cast<double>(timeEnd - timeStart) / static_cast<double>(iterations);
+    }
+
+    // Reproduction of the event storage used by SignalEvent before the pools were cached in the Context:
+    // VectorUnique::Has + VectorUnique::Get (type index, std::optional checks) on every signal.
+    // The listeners are called through the same thunk and listener layout as the engine listeners,
+    // so only the lookup of the pool differs between the measurements
+    namespace Legacy
+    {
+        struct Key {};
+
+        struct Listener {
+            using Function = void (*)();
+            using MemberFunction = void (Listener::*)();
+            union alignas(16) Storage {
+                Function m_Callback;
+                MemberFunction m_CallbackMember;
+            };
+            using Callback = void (*)(Listener&, const void*);
+
+            Storage m_Storage;
+            Callback m_Callback;
+            void* m_System {};
+            std::uint64_t m_SystemsGeneration {};
+            const void* m_Access {};
+        };
+
+        template <std::size_t Listeners>
+        struct Pool {
+            std::vector<Listener> m_Listeners;
+            std::uint32_t m_Depth {};
+        };
+
+        template <std::size_t Listeners>
+        using Storage = Helena::Types::VectorUnique<Key, Pool<Listeners>>;
+
+        template <std::size_t Listeners, std::size_t Index>
+        [[nodiscard]] Listener MakeListener()
+        {
+            using Callback = void (*)(const Event<Listeners>);
+
+            Listener listener{};
+            new (&listener.m_Storage) Callback{&OnEvent<Listeners, Index>};
+            listener.m_Callback = +[](Listener& entry, const void* data) {
+                Callback fn{}; new (&fn) decltype(entry.m_Storage.m_Callback){entry.m_Storage.m_Callback};
+                fn(*static_cast<const Event<Listeners>*>(data));
+            };
+
+            return listener;
+        }
+
+        template <std::size_t Listeners>
+        void Signal(Storage<Listeners>& storage, std::uint64_t value)
+        {
+            if(storage.template Has<Event<Listeners>>())
+            {
+                auto& pool = storage.template Get<Event<Listeners>>();
+                const auto event = Event<Listeners>{value};
+
+                ++pool.m_Depth;
+                for(std::size_t pos = pool.m_Listeners.size(); pos; --pos) {
+                    if(const auto callback = pool.m_Listeners[pos - 1].m_Callback) {
+                        callback(pool.m_Listeners[pos - 1], &event);
+                    }
+                }
+                --pool.m_Depth;
+            }
+        }
+    }
+
+    template <std::size_t Listeners, std::size_t... Index>
+    void SignalEvent(std::size_t iterations, std::index_sequence<Index...>)
+    {
+        // Before: VectorUnique lookups
+        Legacy::Storage<Listeners> storage;
+        if constexpr(Listeners > 0) {
+            storage.template Create<Event<Listeners>>();
+            (storage.template Get<Event<Listeners>>().m_Listeners.emplace_back(Legacy::MakeListener<Listeners, Index>()), ...);
+        }
+
+        const auto before = Measure(iterations, [&storage](std::size_t i) {
+            Legacy::Signal<Listeners>(storage, i);
+        });
+
+        // After: Engine::SignalEvent
+        (Helena::Engine::SubscribeEvent<Event<Listeners>>(&OnEvent<Listeners, Index>), ...);
+
+        const auto after = Measure(iterations, [](std::size_t i) {
+            Helena::Engine::SignalEvent<Event<Listeners>>(i);
+        });
+
+        fmt::print("SignalEvent | listeners: {:>3} | before: {:>8.2f} ns | after: {:>8.2f} ns\n", Listeners, before, after);
+    }
+
+    // Burst of events: synchronous SignalEvent per event vs EnqueueEvent + batched FlushEvents
+    struct Burst {
+        std::uint64_t value;
+    };
+
+    template <std::size_t Index>
+    void OnBurst(const Burst& event) {
+        Counter += event.value + Index;
+    }
+
+    template <std::size_t... Index>
+    void EnqueueEvent(std::size_t events, std::size_t iterations, std::index_sequence<Index...>)
+    {
+        (Helena::Engine::SubscribeEvent<Burst>(&OnBurst<Index>), ...);
+
+        const auto signal = Measure(iterations, [events](std::size_t) {
+            for(std::size_t i = 0; i < events; ++i) {
+                Helena::Engine::SignalEvent<Burst>(i);
+            }
+        }) / static_cast<double>(events);
+
+        const auto enqueue = Measure(iterations, [events](std::size_t) {
+            for(std::size_t i = 0; i < events; ++i) {
+                Helena::Engine::EnqueueEvent<Burst>(i);
+            }
+            Helena::Engine::FlushEvents();
+        }) / static_cast<double>(events);
+
+        fmt::print("EnqueueEvent | events: {} | listeners: {:>3} | signal: {:>8.2f} ns | enqueue + flush: {:>8.2f} ns\n",
+            events, sizeof...(Index), signal, enqueue);
+    }
+
+    // Create and remove of the tasks with random delays: indexed heap vs timing wheel backend,
+    // the second create reuses the slots and the index of the removed tasks (steady state)
+    template <typename Scheduler>
+    [[nodiscard]] std::tuple<double, double, double> SchedulerInsertRemove(std::size_t tasks)
+    {
+        Scheduler scheduler;
+        std::uint64_t seed = 42;
+        const auto fnRandom = [&seed]() {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            return seed >> 33;
+        };
+
+        const auto fnCreate = [&](std::size_t id) {
+            scheduler.Create(id, fnRandom() % 60'000, [](std::uint64_t id, std::uint64_t&, std::uint32_t&) {
+                Counter += id;
+            });
+        };
+
+        const auto fnRemove = [&](std::size_t id) {
+            scheduler.Remove(id);
+        };
+
+        const auto create = Measure(tasks, fnCreate);
+        const auto remove = Measure(tasks, fnRemove);
+        const auto recreate = Measure(tasks, fnCreate);
+        scheduler.Clear();
+
+        return {create, remove, recreate};
+    }
+
+    // Wave of tasks with the same deadline removed by the handles returned from Create
+    template <typename Scheduler>
+    [[nodiscard]] double SchedulerWave(std::size_t tasks)
+    {
+        Scheduler scheduler;
+        std::vector<Helena::Types::TaskHandle> handles(tasks);
+        for(std::size_t id = 0; id < tasks; ++id) {
+            handles[id] = scheduler.Create(id, 60'000, [](std::uint64_t id, std::uint64_t&, std::uint32_t&) {
+                Counter += id;
+            });
+        }
+
+        return Measure(tasks, [&](std::size_t id) {
+            scheduler.Remove(handles[id]);
+        });
+    }
+
+    void TaskSchedulerWave(std::size_t tasks)
+    {
+        const auto sorted = SchedulerWave<Helena::Types::TaskScheduler>(tasks);
+        const auto wheel = SchedulerWave<Helena::Types::TaskSchedulerWheel>(tasks);
+
+        fmt::print("TaskScheduler::Remove(handle) | same deadline: {} | sorted: {:>6.2f} ns, wheel: {:>6.2f} ns\n", tasks, sorted, wheel);
+    }
+
+    // Spawn and despawn of the batch of entities with a timer: Create/Remove per task vs CreateMany/RemoveMany
+    template <typename Scheduler>
+    [[nodiscard]] std::tuple<double, double, double, double> SchedulerBatch(std::size_t tasks)
+    {
+        std::vector<std::uint64_t> ids(tasks);
+        std::uint64_t seed = 42;
+        for(auto& id : ids) {
+            seed = seed * 6364136223846793005ull + 1442695040888963407ull;
+            id = seed >> 16;
+        }
+
+        const auto fnCallback = [](std::uint64_t id, std::uint64_t&, std::uint32_t&) {
+            Counter += id;
+        };
+
+        // Warm pools: the difference is the queue work only
+        Scheduler scheduler;
+        scheduler.Reserve(tasks);
+
+        const auto create = Measure(1, [&](std::size_t) {
+            for(std::size_t index = 0; index < tasks; ++index) {
+                scheduler.Create(ids[index], ids[index] % 60'000, fnCallback);
+            }
+        }) / static_cast<double>(tasks);
+
+        const auto remove = Measure(1, [&](std::size_t) {
+            for(const auto id : ids) {
+                scheduler.Remove(id);
+            }
+        }) / static_cast<double>(tasks);
+
+        std::vector<typename Scheduler::Descriptor> descriptors(tasks);
+        for(std::size_t index = 0; index < tasks; ++index) {
+            descriptors[index] = {.m_Id = ids[index], .m_Delay = std::chrono::milliseconds{ids[index] % 60'000}, .m_Callback = fnCallback};
+        }
+
+        const auto createMany = Measure(1, [&](std::size_t) {
+            scheduler.CreateMany(descriptors);
+        }) / static_cast<double>(tasks);
+
+        const auto removeMany = Measure(1, [&](std::size_t) {
+            scheduler.RemoveMany(std::span<const std::uint64_t>{ids});
+        }) / static_cast<double>(tasks);
+
+        return {create, remove, createMany, removeMany};
+    }
+
+    void TaskSchedulerBatch(std::size_t tasks)
+    {
+        const auto [sortedCreate, sortedRemove, sortedCreateMany, sortedRemoveMany] = SchedulerBatch<Helena::Types::TaskScheduler>(tasks);
+        const auto [wheelCreate, wheelRemove, wheelCreateMany, wheelRemoveMany] = SchedulerBatch<Helena::Types::TaskSchedulerWheel>(tasks);
+
+        fmt::print("TaskScheduler batch | tasks: {} | sorted create: {:>6.2f} ns, CreateMany: {:>6.2f} ns, remove: {:>6.2f} ns, RemoveMany: {:>6.2f} ns"
+            " | wheel create: {:>6.2f} ns, CreateMany: {:>6.2f} ns, remove: {:>6.2f} ns, RemoveMany: {:>6.2f} ns\n",
+            tasks, sortedCreate, sortedCreateMany, sortedRemove, sortedRemoveMany, wheelCreate, wheelCreateMany, wheelRemove, wheelRemoveMany);
+    }
+
+    // Despawn of the entities owning the tasks: Remove of the tracked ids vs RemoveGroup of the entity
+    template <typename Scheduler>
+    [[nodiscard]] std::pair<double, double> SchedulerDespawn(std::size_t entities, std::size_t tasks)
+    {
+        // The same layout of the slots and the queue for both: the schedulers are filled from scratch
+        const auto fnSpawn = [entities, tasks](Scheduler& scheduler) {
+            for(std::size_t entity = 0; entity < entities; ++entity) {
+                for(std::size_t task = 0; task < tasks; ++task) {
+                    scheduler.Create(Helena::Types::TaskGroup{entity}, (entity << 8) | task, 1000 + (entity * 7 + task) % 60'000,
+                        [](std::uint64_t id, std::uint64_t&, std::uint32_t&) {
+                            Counter += id;
+                    });
+                }
+            }
+        };
+
+        Scheduler schedulerIds;
+        fnSpawn(schedulerIds);
+        const auto remove = Measure(entities, [&](std::size_t entity) {
+            for(std::size_t task = 0; task < tasks; ++task) {
+                schedulerIds.Remove((entity << 8) | task);
+            }
+        });
+
+        Scheduler schedulerGroups;
+        fnSpawn(schedulerGroups);
+        const auto group = Measure(entities, [&](std::size_t entity) {
+            schedulerGroups.RemoveGroup(Helena::Types::TaskGroup{entity});
+        });
+
+        return {remove, group};
+    }
+
+    void TaskSchedulerDespawn(std::size_t entities, std::size_t tasks)
+    {
+        const auto [sortedRemove, sortedGroup] = SchedulerDespawn<Helena::Types::TaskScheduler>(entities, tasks);
+        const auto [wheelRemove, wheelGroup] = SchedulerDespawn<Helena::Types::TaskSchedulerWheel>(entities, tasks);
+
+        fmt::print("TaskScheduler despawn | entities: {} x {} tasks | sorted remove ids: {:>7.2f} ns, RemoveGroup: {:>7.2f} ns"
+            " | wheel remove ids: {:>7.2f} ns, RemoveGroup: {:>7.2f} ns per entity\n",
+            entities, tasks, sortedRemove, sortedGroup, wheelRemove, wheelGroup);
+    }
+
+    // Update of the batch of tasks expired at the same time: one clock read per pass vs one clock read per task.
+    // The loop before reads the time source for every fired task, it is reproduced by the read in the callback.
+    template <typename Backend, typename TimeSource, bool ClockPerTask>
+    [[nodiscard]] double SchedulerExpire(std::size_t tasks)
+    {
+        Helena::Types::BasicTaskScheduler<Backend, TimeSource> scheduler;
+        scheduler.Reserve(tasks);
+        for(std::size_t id = 0; id < tasks; ++id) {
+            scheduler.Create(id, 0, [](std::uint64_t id, std::uint64_t&, std::uint32_t&) {
+                if constexpr(ClockPerTask) {
+                    Counter += TimeSource::Now();
+                }
+
+                Counter += id;
+            });
+        }
+
+        // The wheel collects the tasks on the next tick
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        return Measure(1, [&](std::size_t) {
+            scheduler.Update();
+        }) / static_cast<double>(tasks);
+    }
+
+    template <typename Backend, typename TimeSource>
+    [[nodiscard]] std::pair<double, double> SchedulerExpire(std::size_t tasks) {
+        const auto perTask = SchedulerExpire<Backend, TimeSource, true>(tasks);
+        const auto perPass = SchedulerExpire<Backend, TimeSource, false>(tasks);
+        return {perTask, perPass};
+    }
+
+    void TaskSchedulerExpire(std::size_t tasks)
+    {
+        const auto fnPrint = [tasks](std::string_view name, std::pair<double, double> result) {
+            const auto [perTask, perPass] = result;
+            fmt::print("TaskScheduler::Update | expired: {} | {:<12} | clock per task: {:>6.2f} ns, clock per pass: {:>6.2f} ns per task | speedup: {:.2f}x\n",
+                tasks, name, perTask, perPass, perTask / perPass);
+        };
+
+        fnPrint("sorted", SchedulerExpire<Helena::Types::TaskQueueSorted, Helena::Types::TaskClockPrecise>(tasks));
+        fnPrint("wheel", SchedulerExpire<Helena::Types::TaskQueueWheel<>, Helena::Types::TaskClockPrecise>(tasks));
+        fnPrint("wheel coarse", SchedulerExpire<Helena::Types::TaskQueueWheel<>, Helena::Types::TaskClockCoarse>(tasks));
+    }
+
+    // Scripted sequence of steps: coroutine resumed by each Tick vs the task callback rescheduled by Update
+    Helena::Types::Coroutine CoroutineScript(Helena::Types::CoroutineScheduler& scheduler, std::size_t steps)
+    {
+        for(std::size_t step = 0; step < steps; ++step) {
+            co_await scheduler.NextTick();
+            Counter += step;
+        }
+    }
+
+    void Coroutine(std::size_t scripts, std::size_t steps)
+    {
+        Helena::Types::CoroutineScheduler scheduler;
+
+        // Frames of the finished scripts are reused by the next ones
+        const auto spawn = Measure(scripts, [&scheduler, steps](std::size_t) {
+            CoroutineScript(scheduler, steps);
+        });
+
+        const auto resume = Measure(steps, [&scheduler](std::size_t) {
+            scheduler.Tick();
+        }) / static_cast<double>(scripts);
+
+        Helena::Types::TaskScheduler tasks;
+        for(std::size_t id = 0; id < scripts; ++id) {
+            tasks.Create(id, 0, static_cast<std::uint32_t>(steps), [](std::uint64_t id, std::uint64_t&, std::uint32_t&) {
+                Counter += id;
+            });
+        }
+
+        const auto timeNow = Helena::Types::Clock::Now();
+        const auto callback = Measure(steps, [&tasks, timeNow](std::size_t step) {
+            tasks.Update(timeNow + step + 1);
+        }) / static_cast<double>(scripts);
+
+        fmt::print("Coroutine | scripts: {} | spawn: {:>6.2f} ns | resume per step: {:>6.2f} ns | task callback per step: {:>6.2f} ns\n",
+            scripts, spawn, resume, callback);
+    }
+
+    void TaskScheduler(std::size_t tasks)
+    {
+        const auto [sortedCreate, sortedRemove, sortedRecreate] = SchedulerInsertRemove<Helena::Types::TaskScheduler>(tasks);
+        const auto [wheelCreate, wheelRemove, wheelRecreate] = SchedulerInsertRemove<Helena::Types::TaskSchedulerWheel>(tasks);
+
+        fmt::print("TaskScheduler | tasks: {} | sorted create: {:>8.2f} ns, remove: {:>8.2f} ns, recreate: {:>8.2f} ns"
+            " | wheel create: {:>8.2f} ns, remove: {:>8.2f} ns, recreate: {:>8.2f} ns\n",
+            tasks, sortedCreate, sortedRemove, sortedRecreate, wheelCreate, wheelRemove, wheelRecreate);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Helena::Engine::Context::Initialize();
+
+    Benchmark::SignalEvent<0>(10'000'000, std::make_index_sequence<0>{});
+    Benchmark::SignalEvent<1>(10'000'000, std::make_index_sequence<1>{});
+    Benchmark::SignalEvent<100>(1'000'000, std::make_index_sequence<100>{});
+    Benchmark::EnqueueEvent(50'000, 100, std::make_index_sequence<4>{});
+    Benchmark::TaskScheduler(10'000);
+    Benchmark::TaskScheduler(200'000);
+    Benchmark::TaskSchedulerExpire(100'000);
+    Benchmark::TaskSchedulerWave(100'000);
+    Benchmark::TaskSchedulerBatch(10'000);
+    Benchmark::TaskSchedulerBatch(200'000);
+    Benchmark::TaskSchedulerDespawn(50'000, 4);
+    Benchmark::Coroutine(100'000, 10);
+
+    fmt::print("Counter: {}\n", Benchmark::Counter);
+    return 0;
+}
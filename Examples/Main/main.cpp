@@ -134,6 +134,7 @@ void example_signals()
     // I tried to implement them as fast as possible,
     // I think it's obvious that events should notify listeners as quickly as possible and without overhead.
     // And by the way, it's not thread safe but there are reasons for this, which are also related to optimization.
+    // Other threads can use PostEvent, the events are delivered by the engine thread in the next Heartbeat.
 
     // Let's look at how to use signals/events
     // The signal can be absolutely any type, but I would recommend struct.
@@ -163,12 +164,27 @@ void example_signals()
     // Notify
     Helena::Engine::SignalEvent<InfoSignal>("Alex", 30);
 
+    // The event is constructed once and all listeners receive it by reference,
+    // an existing object can be passed directly without copying
+    const InfoSignal info{"Helena", 1};
+    Helena::Engine::SignalEvent(info);
+
+    // Signals can also be queued: the events are stored in the buffer of the event type
+    // and the listeners are triggered over the whole batch in the Heartbeat (see Context::SetEventFlush)
+    Helena::Engine::EnqueueEvent<InfoSignal>("Queued", 2);
+
     // How to use signals for systems, see the TestSystemA class
 
     // As for performance Engine, you don't have to worry, in most cases it's O(1)
-    // The exception is UnsubscribeEvent, complexity: O(n)
-    // But you don't have to worry about it, usually there are very few listeners,
-    // and UnsubscribeEvent will be called very rarely or only when execution is completed
+    // The exception is UnsubscribeEvent by the callback, complexity: O(n)
+    // SubscribeEvent returns a handle, UnsubscribeEvent by the handle is O(1)
+    // and it is safe to call it inside the listeners
+    const auto handle = Helena::Engine::SubscribeEvent<MySignal>(+[]() {
+        HELENA_MSG_NOTICE("Hello signal once: {}", Helena::Traits::NameOf<MySignal>{});
+    });
+
+    Helena::Engine::SignalEvent<MySignal>();
+    Helena::Engine::UnsubscribeEvent(handle);
 }
 
 void example_task_sheduler()
@@ -276,6 +292,13 @@ void example_task_sheduler()
         HELENA_MSG_INFO("Task entity id: {}, task id: {}, type: {}, ms: {}, repeat: {}", entityID, id, taskType, ms, repeat);
     });
 
+    // The tasks can belong to the group, e.g. to the entity:
+    // all tasks of the entity are removed by RemoveGroup on despawn without tracking the ids
+    const auto entity = Helena::Types::TaskGroup{100};
+    scheduler.Create(entity, (100uLL << 8) | 11, 5000, [](std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat) {});
+    scheduler.Create(entity, (100uLL << 8) | 12, 7000, [](std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat) {});
+    HELENA_MSG_INFO("Entity tasks removed: {}", scheduler.RemoveGroup(entity));
+
 
     // The scheduler cannot work by itself
     // You must call Update so that the scheduler calls events whose time has come
@@ -303,18 +326,93 @@ void example_task_sheduler()
     //  Update task (Remove): O(1) + O(logN) (when need remove task)
 }
 
+void example_jobs()
+{
+    // Engine owns a work-stealing thread pool,
+    // workers are started with the engine and stopped on shutdown.
+    // By default the pool uses (hardware concurrency - 1) workers,
+    // the engine thread also executes jobs while waiting for them.
+    // You can change it before the engine started: Helena::Engine::Context::SetJobWorkers(N);
+
+    // Submit returns std::future, use WaitJobs(future) to help the pool instead of blocking
+    auto future = Helena::Engine::Submit([](int value) {
+        return value * 2;
+    }, 21);
+
+    Helena::Engine::WaitJobs(future);
+    HELENA_MSG_INFO("Job result: {}", future.get());
+
+    // ParallelFor splits the range into chunks and returns when all indexes are processed
+    // Systems can fan out work in the Update event, all jobs are joined before Render
+    std::vector<std::uint64_t> values(1024);
+    Helena::Engine::ParallelFor(0, values.size(), [&values](std::size_t index) {
+        values[index] = index * index;
+    });
+
+    HELENA_MSG_INFO("ParallelFor last value: {}", values.back());
+
+    // Jobs notify the engine thread with PostEvent, listeners are called by the engine thread
+    struct JobDone {
+        std::uint64_t value;
+    };
+
+    Helena::Engine::SubscribeEvent<JobDone>(+[](const JobDone event) {
+        HELENA_MSG_INFO("JobDone posted from the worker: {}", event.value);
+    });
+
+    Helena::Engine::WaitJobs(Helena::Engine::Submit([]() {
+        Helena::Engine::PostEvent<JobDone>(42u);
+    }));
+}
+
+// Scripted sequence without the chain of task callbacks
+struct PlayerJoined {
+    std::uint64_t id;
+};
+
+Helena::Types::Coroutine example_coroutine_script()
+{
+    // The coroutine runs until the first co_await, then it is resumed by the engine loop
+    [[maybe_unused]] const auto event = co_await Helena::Engine::WaitEvent<PlayerJoined>();
+    HELENA_MSG_INFO("Coroutine: player {} joined", event.id);
+
+    // Resumed by the first frame after the delay
+    co_await Helena::Engine::Delay(std::chrono::milliseconds{500});
+    HELENA_MSG_INFO("Coroutine: welcome message sent");
+
+    // Resumed after the listeners of the next fixed Update tick
+    for(int tick = 0; tick < 3; ++tick) {
+        co_await Helena::Engine::NextUpdate();
+        HELENA_MSG_INFO("Coroutine: update tick {}", tick);
+    }
+}
+
+void example_coroutines()
+{
+    // Frames of the coroutines are reused from the pool,
+    // the coroutines suspended at the shutdown are destroyed by the engine
+    example_coroutine_script();
+
+    Helena::Engine::SignalEvent<PlayerJoined>(7u);
+}
+
 int main(int argc, char** argv)
 {
     //Engine started from Initialize method
     Helena::Engine::Context::Initialize();                  // Initialize Context (Context used in Engine)
     Helena::Engine::Context::SetAppName("Helena");          // Set application name
     Helena::Engine::Context::SetTickrate(30.f);             // Set Update tickrate
+    Helena::Engine::Context::SetTickPolicy(Helena::Engine::ETickPolicy::Drop, 3); // Max 3 Update ticks per frame, drop the rest
+    Helena::Engine::Context::SetPacing(Helena::Engine::EPacing::Balanced); // Sleep until the next Update tick
+    Helena::Engine::Context::SetFrameProfiler(true); // Record the phases of frames, see Engine::ExportFrameTrace
     Helena::Engine::Context::SetMain([]() {                 // Register systems happen in this callback
         Helena::Engine::RegisterSystem<TestSystemA>();
 
         example_systems();          // ok, here just example how use systems
         example_signals();          // here example with signals
         example_task_sheduler();    // task scheduler example
+        example_jobs();             // job system example
+        example_coroutines();       // coroutines resumed by the engine loop
     });
 
     // Engine loop
@@ -6,16 +6,34 @@
 #include <Helena/Platform/Platform.hpp>
 #include <Helena/Platform/Defines.hpp>
 #include <Helena/Platform/Assert.hpp>
-#include <Helena/Types/VectorAny.hpp>
-#include <Helena/Types/VectorUnique.hpp>
+#include <Helena/Traits/Remove.hpp>
+#include <Helena/Traits/SameAS.hpp>
+#include <Helena/Traits/Specialization.hpp>
+#include <Helena/Types/Coroutine.hpp>
+#include <Helena/Types/FlatIndex.hpp>
+#include <Helena/Types/FrameProfiler.hpp>
+#include <Helena/Types/Histogram.hpp>
+#include <Helena/Types/InplaceFunction.hpp>
+#include <Helena/Types/JobSystem.hpp>
+#include <Helena/Types/MPSCQueue.hpp>
+#include <Helena/Types/Reactor.hpp>
+#include <Helena/Types/VectorArena.hpp>
+#include <Helena/Types/UniqueIndexer.hpp>
 #include <Helena/Types/LocationString.hpp>
 #include <Helena/Types/Mutex.hpp>
 
 #include <algorithm>
+#include <array>
 #include <cstring>
+#include <chrono>
 #include <functional>
+#include <future>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <type_traits>
 #include <utility>
@@ -34,6 +52,22 @@ namespace Helena
         //! Unique key for storage systems type index
         using UKSystems = IUniqueKey<1>;
 
+        //! Accesses declared by the system (see Engine::Reads)
+        template <typename System>
+        using SystemReads = typename System::Reads;
+
+        template <typename System>
+        using SystemWrites = typename System::Writes;
+
+        //! Resources declared by the system (see Engine::Reads and Engine::Writes), the system writes itself
+        struct SystemAccess {
+            using Find = void* (*)();
+
+            std::span<const std::uint64_t> m_Reads;
+            std::span<const std::uint64_t> m_Writes;
+            Find m_Find;    // Resolve the system, nullptr if the system is removed
+        };
+
         //! Event callback storage with type erasure
         struct CallbackStorage
         {
@@ -43,15 +77,18 @@ namespace Helena
                 Function m_Callback;
                 MemberFunction m_CallbackMember;
             };
-            using Callback = void (*)(Storage&, void*);
+            using Callback = void (*)(CallbackStorage&, const void*);
 
+            // The unused bytes of the storage are zeroed: the key of the callback is computed from all bytes
             template <typename Ret, typename... Args>
             CallbackStorage(Ret (*callback)(Args...), Callback cb) : m_Callback{cb} {
+                std::memset(&m_Storage, 0, sizeof(m_Storage));
                 new (&m_Storage) decltype(callback){callback};
             }
 
             template <typename Ret, typename T, typename... Args>
             CallbackStorage(Ret (T::*callback)(Args...), Callback cb) : m_Callback{cb} {
+                std::memset(&m_Storage, 0, sizeof(m_Storage));
                 new (&m_Storage) decltype(callback){callback};
             }
 
@@ -62,16 +99,32 @@ namespace Helena
 
             template <typename Ret, typename... Args>
             CallbackStorage& operator=(Ret (*callback)(Args...)) noexcept {
+                std::memset(&m_Storage, 0, sizeof(m_Storage));
                 new (&m_Storage) decltype(callback){callback};
                 return *this;
             }
 
             template <typename Ret, typename T, typename... Args>
             CallbackStorage& operator=(Ret (T::*callback)(Args...)) noexcept {
+                std::memset(&m_Storage, 0, sizeof(m_Storage));
                 new (&m_Storage) decltype(callback){callback};
                 return *this;
             }
 
+            //! Key of the callback in EventPool::m_Callbacks, unique for the free functions
+            [[nodiscard]] std::uint64_t Key() const noexcept
+            {
+                std::array<std::uint64_t, sizeof(Storage) / sizeof(std::uint64_t)> words{};
+                std::memcpy(words.data(), &m_Storage, sizeof(Storage));
+
+                std::uint64_t key{};
+                for(const auto word : words) {
+                    key = key * 0x9E3779B97F4A7C15ull ^ word;
+                }
+
+                return key;
+            }
+
             template <typename Ret, typename... Args>
             [[nodiscard]] bool operator==(Ret (*callback)(Args...)) const noexcept {
                 decltype(callback) fn{}; std::memcpy(&fn, &m_Storage, sizeof(callback));
@@ -96,8 +149,107 @@ namespace Helena
 
             Storage m_Storage;
             Callback m_Callback;
+            void* m_System {};                  // Cached system of the member listener
+            std::uint64_t m_SystemsGeneration {};   // Context systems generation of the cached system
+            const SystemAccess* m_Access {};    // Declared accesses of the member listener system, nullptr if not declared
+        };
+
+        //! Listeners share the single event object: it can be taken by value or by const reference only
+        template <typename Event, typename Arg>
+        static constexpr bool IsEventArgument = Traits::SameAS<Arg, Traits::RemoveCV<Event>>
+            || Traits::SameAS<Arg, const Event>
+            || Traits::SameAS<Arg, const Event&>;
+
+        //! Deferred events of the event type, the listeners are flushed over the whole batch
+        template <typename Event>
+        struct EventQueue {
+            std::vector<Event> m_Pending;
+            std::vector<Event> m_Flushing;
+        };
+
+        //! Listeners of the event type
+        struct EventPool
+        {
+            using Flush = void (*)(EventPool&, bool);
+            using Deleter = void (*)(void*) noexcept;
+
+            //! Handle indirection: position of the listener (or the next free slot) and generation
+            struct Slot {
+                std::uint32_t m_Index;
+                std::uint32_t m_Generation;
+            };
+
+            static constexpr auto SlotNone = (std::numeric_limits<std::uint32_t>::max)();
+
+            // Unsubscribed listeners are tombstones (null callback) until the compaction
+            std::vector<CallbackStorage> m_Listeners {};
+            std::vector<std::uint32_t> m_ListenerSlots {};  // Slot of the listener, parallel to m_Listeners
+            std::vector<Slot> m_Slots {};
+            std::uint32_t m_SlotFree {SlotNone};
+            Types::FlatIndex m_Callbacks {};                // Slot of the subscribed callback by the key of the callback
+            bool m_CallbacksCollision {};                   // The callback not indexed by the key collision: lookup falls back to the scan
+            std::uint32_t m_Tombstones {};
+            std::uint32_t m_Depth {};                       // Depth of the dispatches in progress
+            std::uint64_t m_Version {};                     // Incremented when the listeners are changed
+            std::unique_ptr<void, Deleter> m_Queue {nullptr, nullptr};  // EventQueue<Event>, created on the first EnqueueEvent
+            Flush m_Flush {};                               // Dispatch the swapped events (true) or swap the buffers (false)
+            bool m_Queued {};   // The pool is in the list of pools with pending events
+
+        #if defined(HELENA_ENGINE_EVENT_STATS)
+            //! Dispatch time of the listener, kept after the unsubscribe
+            struct Profile {
+                std::string_view m_Name;
+                std::uintptr_t m_Address;
+                Types::Histogram<> m_Time;
+            };
+
+            std::string_view m_Name {};
+            Types::Histogram<> m_Time {};
+            std::vector<std::unique_ptr<Profile>> m_Profiles {};
+            std::vector<Profile*> m_ListenerProfiles {};    // Profile of the listener, parallel to m_Listeners
+        #endif
+        };
+
+        //! Levels of the Update listeners: listeners of the same level have no conflicting accesses
+        struct UpdateSchedule {
+            std::vector<std::uint32_t> m_Listeners {};  // Positions of the listeners in the pool, grouped by level in the dispatch order
+            std::vector<std::uint32_t> m_Levels {};     // End of each level in m_Listeners
+            std::uint64_t m_Version {};                 // Version of the Update pool
+            std::uint64_t m_SystemsGeneration {};       // Systems generation of the resolved systems
+            bool m_Parallel {};                         // At least one level has more than one listener
         };
-        
+
+        //! Event posted from other threads, stored inline in the slot of the post queue
+        struct PostedEvent
+        {
+            // Slot of the post queue is one cacheline: sequence + function + event
+            static constexpr std::size_t Capacity = 48;
+
+            using Function = void (*)(std::byte*, bool);
+
+            template <typename Event, typename... Args>
+            PostedEvent(std::in_place_type_t<Event>, [[maybe_unused]] Args&&... args) noexcept : m_Function{&PostedEventFunction<Event>}
+            {
+                if constexpr(std::is_aggregate_v<Event>) {
+                    new (&m_Storage) Event{std::forward<Args>(args)...};
+                } else {
+                    new (&m_Storage) Event(std::forward<Args>(args)...);
+                }
+            }
+
+            ~PostedEvent() {
+                m_Function(m_Storage, false);
+            }
+
+            PostedEvent(const PostedEvent&) = delete;
+            PostedEvent(PostedEvent&&) noexcept = delete;
+            PostedEvent& operator=(const PostedEvent&) = delete;
+            PostedEvent& operator=(PostedEvent&&) noexcept = delete;
+
+            Function m_Function;    // Dispatch the event to the listeners (true) or destroy it (false)
+            alignas(void*) std::byte m_Storage[Capacity];
+        };
+
     public:
         //! Engine states
         enum class EState : std::uint8_t
@@ -107,6 +259,161 @@ namespace Helena
             Shutdown
         };
 
+        //! Engine frame pacing modes
+        enum class EPacing : std::uint8_t
+        {
+            LowPower,   // Sleep until the next deadline, the wakeup latency depends on the OS timer slack
+            Balanced,   // Sleep until shortly before the next deadline and spin the rest
+            BusyPoll,   // Never sleep, Heartbeat returns immediately
+            Reactor     // Block in epoll until the deadline, a posted event or a signal (Linux, LowPower on other platforms)
+        };
+
+        //! Fixed Update policy for the ticks over the catch-up limit
+        enum class ETickPolicy : std::uint8_t
+        {
+            Drop,       // Discard the ticks, the simulation skips the lost time
+            Dilate      // Keep the ticks for the next frames, the simulation time slows down
+        };
+
+        //! Heartbeat phase for flushing the events queued by EnqueueEvent
+        enum class EEventFlush : std::uint8_t
+        {
+            AfterTick,      // After the "Tick" event
+            AfterUpdate,    // After every fixed "Update" tick
+            BeforeRender,   // Before the "Render" event
+            Manual          // Only by the Engine::FlushEvents call
+        };
+
+        /**
+        * @brief Resources read by the system in the Update listeners
+        *
+        * @code{.cpp}
+        * struct Transforms {};  // Any type can be a resource: components, systems, tags
+        *
+        * struct PhysicsSystem {
+        *   using Reads = Helena::Engine::Reads<Transforms, ConfigSystem>;
+        *   using Writes = Helena::Engine::Writes<Velocities>;
+        *
+        *   PhysicsSystem() {
+        *       Helena::Engine::SubscribeEvent<Helena::Events::Engine::Update>(&PhysicsSystem::OnUpdate);
+        *   }
+        *
+        *   void OnUpdate(const Helena::Events::Engine::Update& event);
+        * };
+        * @endcode
+        *
+        * @tparam T Types of resources
+        * @note
+        * The Update listeners of the systems with declared accesses are scheduled by levels:
+        * a listener runs after every earlier (in the dispatch order) listener with a conflicting access,
+        * listeners of the same level run in parallel on the engine thread pool and the level is joined
+        * before the next one. Accesses conflict if one of them writes the resource read or written by the other,
+        * the system always writes itself. Listeners of the systems without declarations and free function
+        * listeners conflict with all, by default the order is the same as for SignalEvent.
+        * @warning Parallel listeners can't subscribe, unsubscribe, signal or enqueue events, register or remove systems,
+        * use PostEvent, Submit or ParallelFor instead
+        */
+        template <typename... T>
+        struct Reads {
+            static constexpr std::array<std::uint64_t, sizeof...(T)> Keys {Types::Hash<std::uint64_t>::template Get<T>()...};
+        };
+
+        /**
+        * @brief Resources written by the system in the Update listeners
+        * @tparam T Types of resources
+        * @note See Engine::Reads
+        */
+        template <typename... T>
+        struct Writes {
+            static constexpr std::array<std::uint64_t, sizeof...(T)> Keys {Types::Hash<std::uint64_t>::template Get<T>()...};
+        };
+
+        //! Fixed Update counters
+        struct TickStats
+        {
+            std::uint64_t m_Executed;   // Update ticks executed
+            std::uint64_t m_Skipped;    // Update ticks discarded by the policy or the backlog guard
+            std::uint64_t m_Late;       // Update ticks executed behind schedule (catch-up)
+        };
+
+        //! Handle of the event listener returned by SubscribeEvent
+        struct EventHandle
+        {
+            [[nodiscard]] explicit operator bool() const noexcept {
+                return m_Generation;
+            }
+
+            std::uint32_t m_Pool;           // Type index of the event
+            std::uint32_t m_Slot;           // Slot of the listener in the pool
+            std::uint32_t m_Generation;     // Generation of the slot, zero for the empty handle
+        };
+
+        //! Dispatch time of the event listener (HELENA_ENGINE_EVENT_STATS)
+        struct EventListenerStats
+        {
+            std::string_view m_Name;    // Name of the system for the member listeners
+            std::uintptr_t m_Address;   // Address of the callback
+            std::uint64_t m_Count;      // Calls
+            std::uint64_t m_Total;      // Total time in nanoseconds
+            std::uint64_t m_Max;        // Max time in nanoseconds
+            std::uint64_t m_P99;        // 99th percentile time in nanoseconds
+        };
+
+        //! Dispatch time of the event type (HELENA_ENGINE_EVENT_STATS)
+        struct EventStats
+        {
+            std::string_view m_Name;    // Name of the event type
+            std::uint64_t m_Count;      // Dispatches (a flush of the queued events is a single dispatch)
+            std::uint64_t m_Total;      // Total time in nanoseconds
+            std::uint64_t m_Max;        // Max time in nanoseconds
+            std::uint64_t m_P99;        // 99th percentile time in nanoseconds
+            std::vector<EventListenerStats> m_Listeners;    // Sorted by total time
+        };
+
+        //! Counters of the events posted from other threads
+        struct PostStats
+        {
+            std::uint64_t m_Posted;         // Events pushed to the post queue
+            std::uint64_t m_Dispatched;     // Events dispatched by the engine thread
+            std::uint64_t m_Overflow;       // Events dropped because the post queue was full
+            std::uint64_t m_Backpressure;   // Posts that found the queue full and had to wait for the engine thread
+            std::uint64_t m_HighWater;      // Maximum number of events found by the engine thread in the post queue
+        };
+
+        //! Awaiter of the event returned by WaitEvent: the coroutine is resumed by the next Tick with the copy of the event
+        template <typename Event>
+        class EventAwaiter
+        {
+            friend class Engine;
+
+            EventAwaiter() noexcept = default;
+
+        public:
+            ~EventAwaiter();
+            EventAwaiter(const EventAwaiter&) = delete;
+            EventAwaiter(EventAwaiter&&) noexcept = delete;
+            EventAwaiter& operator=(const EventAwaiter&) = delete;
+            EventAwaiter& operator=(EventAwaiter&&) noexcept = delete;
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(Types::Coroutine::Handle handle);
+            [[nodiscard]] Event await_resume();
+
+        private:
+            static void OnEvent(CallbackStorage& listener, const void* data);
+            void Unsubscribe() noexcept;
+
+        private:
+            std::optional<Event> m_Event;
+            Types::Coroutine::Handle m_Handle;
+            EventPool* m_Pool {};               // Pools never move, the pool is alive until the context is destroyed
+            std::uint32_t m_Slot {};
+            std::uint32_t m_Generation {};
+        };
+
         //! Context for storage framework data
         class Context
         {
@@ -119,9 +426,30 @@ namespace Helena
             };
 
             static constexpr auto DefaultTickrate = 1.f / 30.f;
+            static constexpr std::uint32_t DefaultTickMaxSteps = 3;
+            static constexpr std::uint32_t DefaultTickMaxBacklog = 8;
+            static constexpr auto DefaultPacingSpin = std::chrono::microseconds{200};
+            static constexpr auto TimeWakeupNone = (std::numeric_limits<std::uint64_t>::max)();
+            static constexpr std::size_t PostCapacity = 4096;
+            static constexpr std::uint32_t PostRetries = 64;
+
+        #if defined(HELENA_ENGINE_NOSLEEP)
+            static constexpr auto DefaultPacing = EPacing::BusyPoll;
+        #else
+            static constexpr auto DefaultPacing = EPacing::Balanced;
+        #endif
+
+            [[nodiscard]] static std::size_t DefaultJobWorkers() noexcept {
+                const auto threads = std::thread::hardware_concurrency();
+                return threads > 1 ? threads - 1 : 0;
+            }
 
         protected:
-            using Callback = std::function<void ()>;
+            using Callback = Types::InplaceFunction<void ()>;
+
+            [[nodiscard]] static std::uint64_t TickPeriod(float tickrate) noexcept {
+                return (std::max)(std::uint64_t{1}, static_cast<std::uint64_t>(static_cast<double>(tickrate) * 1'000'000'000.0));
+            }
 
             template <typename T = Context>
             static T& GetInstance() noexcept {
@@ -132,19 +460,46 @@ namespace Helena
         public:
             Context() noexcept
                 : m_Systems{}
+                , m_SystemsGeneration{1}
+                , m_EventIndexer{}
                 , m_Events{}
+                , m_EventsQueued{}
+                , m_EventsFlushing{}
+                , m_UpdateSchedule{}
+                , m_Posts{}
+                , m_Reactor{}
+                , m_PostOverflow{}
+                , m_PostBackpressure{}
+                , m_PostDispatched{}
+                , m_PostHighWater{}
                 , m_Callback{}
+                , m_Jobs{}
+                , m_Coroutines{}
                 , m_ShutdownMessage{}
                 , m_ApplicationName{}
+                , m_JobWorkers{DefaultJobWorkers()}
                 , m_Tickrate{DefaultTickrate}
                 , m_DeltaTime{}
-                , m_TimeElapsed{}
+                , m_TickStats{}
+                , m_TickPeriod{TickPeriod(DefaultTickrate)}
+                , m_TickAccumulator{}
+                , m_TickMaxSteps{DefaultTickMaxSteps}
+                , m_TickMaxBacklog{DefaultTickMaxBacklog}
+                , m_TickPolicy{ETickPolicy::Drop}
                 , m_TimeStart{}
                 , m_TimeNow{}
                 , m_TimePrev{}
+                , m_TimeWakeup{TimeWakeupNone}
+                , m_Pacing{DefaultPacing}
+                , m_EventFlush{EEventFlush::BeforeRender}
+                , m_FrameProfiler{}
+                , m_FrameProfiling{}
                 , m_State{EState::Undefined} {}
             ~Context() {
-                m_Events.Clear();
+                m_Jobs.Stop();
+                m_Coroutines.Clear();
+                m_EventsQueued.clear();
+                m_Events.clear();
                 m_Systems.Clear();
             }
             Context(const Context&) = delete;
@@ -210,6 +565,96 @@ namespace Helena
             static void SetTickrate(float tickrate) noexcept {
                 auto& ctx = GetInstance();
                 ctx.m_Tickrate = 1.f / (std::max)(tickrate, 1.f);
+                ctx.m_TickPeriod = TickPeriod(ctx.m_Tickrate);
+            }
+
+            /**
+            * @brief Set the catch-up policy for the engine "Update" event
+            * @param policy Policy for the ticks over the maxSteps limit
+            * @param maxSteps Maximum number of Update ticks per frame
+            * @param maxBacklog Maximum number of ticks kept for the next frames (spiral-of-death guard)
+            * @note
+            * By default, ETickPolicy::Drop, 3 steps per frame and 8 ticks of backlog
+            * ETickPolicy::Drop discards the ticks over maxSteps
+            * ETickPolicy::Dilate keeps them, but never more than maxBacklog ticks
+            */
+            static void SetTickPolicy(ETickPolicy policy, std::uint32_t maxSteps = DefaultTickMaxSteps, std::uint32_t maxBacklog = DefaultTickMaxBacklog) noexcept {
+                auto& ctx = GetInstance();
+                ctx.m_TickPolicy = policy;
+                ctx.m_TickMaxSteps = (std::max)(maxSteps, 1u);
+                ctx.m_TickMaxBacklog = maxBacklog;
+            }
+
+            /**
+            * @brief Reset the counters of the engine "Update" event
+            */
+            static void ResetTickStats() noexcept {
+                auto& ctx = GetInstance();
+                ctx.m_TickStats = {};
+            }
+
+            /**
+            * @brief Reserve the arena memory for the systems
+            * @param size Size in bytes
+            * @note
+            * Systems are placed one after another in the cacheline-aligned arena chunks (64 KiB by default),
+            * reserve the total size of the systems before RegisterSystem to keep them all in one chunk
+            */
+            static void ReserveSystems(std::size_t size) {
+                auto& ctx = GetInstance();
+                ctx.m_Systems.Reserve(size);
+            }
+
+            /**
+            * @brief Set the number of job worker threads
+            * @param workers Number of worker threads
+            * @note
+            * By default, hardware concurrency - 1 (the engine thread also executes jobs)
+            * Workers are started on the EState::Init transition and stopped on EState::Shutdown
+            * With zero workers, jobs are executed by the engine thread when it waits for them
+            */
+            static void SetJobWorkers(std::size_t workers) noexcept {
+                auto& ctx = GetInstance();
+                ctx.m_JobWorkers = workers;
+            }
+
+            /**
+            * @brief Set the frame pacing mode
+            * @param pacing Pacing mode
+            * @note
+            * The engine sleeps until the next fixed Update tick or the time passed to Engine::WakeupAt
+            * By default, EPacing::Balanced (EPacing::BusyPoll if HELENA_ENGINE_NOSLEEP is defined)
+            * EPacing::Reactor also wakes up on PostEvent and Shutdown from other threads and receives
+            * SIGINT/SIGTERM/SIGHUP by the signalfd if it is selected before the first Heartbeat
+            * (the signals are blocked in the engine thread and the job workers started after it)
+            */
+            static void SetPacing(EPacing pacing) noexcept {
+                auto& ctx = GetInstance();
+                ctx.m_Pacing = pacing;
+            }
+
+            /**
+            * @brief Set the Heartbeat phase for flushing the queued events
+            * @param phase Flush phase
+            * @note By default, EEventFlush::BeforeRender
+            */
+            static void SetEventFlush(EEventFlush phase) noexcept {
+                auto& ctx = GetInstance();
+                ctx.m_EventFlush = phase;
+            }
+
+            /**
+            * @brief Enable the frame profiler
+            * @param enable Record the phases of the Heartbeat frames
+            * @note
+            * The profiler keeps the recent frames with the time of Tick, every fixed Update,
+            * Render and Sleep phases, and the histogram of all frame times.
+            * Use Engine::ExportFrameTrace to save the frames as Chrome trace JSON.
+            * By default, disabled
+            */
+            static void SetFrameProfiler(bool enable) noexcept {
+                auto& ctx = GetInstance();
+                ctx.m_FrameProfiling = enable;
             }
 
             /**
@@ -242,22 +687,118 @@ namespace Helena
                 return ctx.m_Tickrate;
             }
 
+            /**
+            * @brief Returns the counters of the engine "Update" event
+            * @return Executed, skipped and late ticks since start or the last ResetTickStats
+            */
+            [[nodiscard]] static TickStats GetTickStats() noexcept {
+                const auto& ctx = GetInstance();
+                return ctx.m_TickStats;
+            }
+
+            /**
+            * @brief Returns the counters of the events posted from other threads
+            * @return Posted, dispatched, overflow, backpressure counters and high-water mark since start
+            */
+            [[nodiscard]] static PostStats GetPostStats() noexcept {
+                const auto& ctx = GetInstance();
+                return PostStats {
+                    .m_Posted = ctx.m_Posts.Pushed(),
+                    .m_Dispatched = ctx.m_PostDispatched,
+                    .m_Overflow = ctx.m_PostOverflow.load(std::memory_order_relaxed),
+                    .m_Backpressure = ctx.m_PostBackpressure.load(std::memory_order_relaxed),
+                    .m_HighWater = ctx.m_PostHighWater
+                };
+            }
+
+            /**
+            * @brief Returns the current frame pacing mode
+            * @return EPacing mode
+            */
+            [[nodiscard]] static EPacing GetPacing() noexcept {
+                const auto& ctx = GetInstance();
+                return ctx.m_Pacing;
+            }
+
+            /**
+            * @brief Returns the Heartbeat phase for flushing the queued events
+            * @return EEventFlush phase
+            */
+            [[nodiscard]] static EEventFlush GetEventFlush() noexcept {
+                const auto& ctx = GetInstance();
+                return ctx.m_EventFlush;
+            }
+
+            /**
+            * @brief Returns the frame profiler
+            * @return Recent frames and the histogram of the frame times
+            */
+            [[nodiscard]] static const Types::FrameProfiler<>& GetFrameProfiler() noexcept {
+                const auto& ctx = GetInstance();
+                return ctx.m_FrameProfiler;
+            }
+
+            /**
+            * @brief Returns the number of job worker threads
+            * @return Number of workers
+            */
+            [[nodiscard]] static std::size_t GetJobWorkers() noexcept {
+                const auto& ctx = GetInstance();
+                return ctx.m_JobWorkers;
+            }
+
         private:
-            Types::VectorAny<UKSystems> m_Systems;
-            Types::VectorUnique<UKEventStorage, std::vector<CallbackStorage>> m_Events;
+            // Systems are allocated in the cacheline-aligned arena chunks, the addresses are stable
+            Types::VectorArena<UKSystems> m_Systems;
+            // Incremented by RegisterSystem/RemoveSystem: systems can be moved or destroyed,
+            // member listeners resolve the cached system pointer again
+            std::uint64_t m_SystemsGeneration;
+            // Pools are allocated once per event type and never move,
+            // SignalEvent resolves the pool by the type index without any lookups
+            Types::UniqueIndexer<UKEventStorage> m_EventIndexer;
+            std::vector<std::unique_ptr<EventPool>> m_Events;
+            std::vector<EventPool*> m_EventsQueued;
+            std::vector<EventPool*> m_EventsFlushing;
+            UpdateSchedule m_UpdateSchedule;
+
+            // Events posted from other threads, drained by the engine thread in the Heartbeat
+            Types::MPSCQueue<PostedEvent, PostCapacity> m_Posts;
+            Types::Reactor m_Reactor;
+            alignas(Traits::Cacheline) std::atomic<std::uint64_t> m_PostOverflow;
+            std::atomic<std::uint64_t> m_PostBackpressure;
+            std::uint64_t m_PostDispatched;
+            std::uint64_t m_PostHighWater;
 
             Callback m_Callback;
+            Types::JobSystem m_Jobs;
+            // Coroutines suspended by Engine::Delay, NextTick, NextUpdate and WaitEvent
+            Types::CoroutineScheduler m_Coroutines;
 
             ShutdownMessage m_ShutdownMessage;
             std::string m_ApplicationName;
+            std::size_t m_JobWorkers;
 
             float m_Tickrate;
             float m_DeltaTime;
-            float m_TimeElapsed;
 
+            TickStats m_TickStats;
+            std::uint64_t m_TickPeriod;
+            std::uint64_t m_TickAccumulator;
+            std::uint32_t m_TickMaxSteps;
+            std::uint32_t m_TickMaxBacklog;
+            ETickPolicy m_TickPolicy;
+
+            // Time in nanoseconds of Types::Clock
             std::uint64_t m_TimeStart;
             std::uint64_t m_TimeNow;
             std::uint64_t m_TimePrev;
+            std::uint64_t m_TimeWakeup;
+
+            EPacing m_Pacing;
+            EEventFlush m_EventFlush;
+
+            Types::FrameProfiler<> m_FrameProfiler;
+            bool m_FrameProfiling;
 
             std::atomic<Engine::EState> m_State;
 
@@ -274,6 +815,54 @@ namespace Helena
     #endif
 
         static void RegisterHandlers();
+        template <typename Event>
+        [[nodiscard]] static EventPool* FindEventPool(Context& ctx);
+
+        template <typename Event>
+        [[nodiscard]] static EventPool& GetEventPool(Context& ctx);
+
+        static void ClearEvents(Context& ctx) noexcept;
+
+        template <typename Event, typename Callback>
+        [[nodiscard]] static EventHandle FindListener(Context& ctx, Callback callback);
+        static void IndexListener(EventPool& pool, std::uint32_t slot);
+
+        template <typename Event, typename System = void>
+        [[nodiscard]] static EventHandle AddListener(Context& ctx, CallbackStorage listener);
+
+        static void RemoveListener(EventPool& pool, std::size_t index) noexcept;
+        static void CompactListeners(EventPool& pool) noexcept;
+        static void ClearListeners(EventPool& pool) noexcept;
+
+        template <typename Event>
+        static void DispatchEvent(EventPool& pool, const void* event);
+
+        template <typename System>
+        [[nodiscard]] static const SystemAccess* GetSystemAccess() noexcept;
+
+        template <typename System>
+        [[nodiscard]] static void* FindSystem();
+
+        [[nodiscard]] static bool HasConflict(const SystemAccess* lhs, const SystemAccess* rhs) noexcept;
+        static void BuildUpdateSchedule(Context& ctx, EventPool& pool);
+        static void InvokeListener(EventPool& pool, std::size_t index, const void* event);
+        static void DispatchUpdate(Context& ctx, const Events::Engine::Update& event);
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        static void ProfileListener(EventPool& pool, std::size_t index, const void* event);
+        static void LogEventStats();
+    #endif
+
+        template <typename Event>
+        static void FlushEventQueue(EventPool& pool, bool dispatch);
+
+        template <typename Event>
+        static void PostedEventFunction(std::byte* storage, bool dispatch);
+
+        static void DrainPostedEvents(Context& ctx);
+
+        static void FixedUpdate(Context& ctx);
+        static void Pacing(Context& ctx);
 
     public:
         /**
@@ -286,7 +875,8 @@ namespace Helena
         * @return True if successful or false if an error is detected or called shutdown
         * @note 
         * You have to call heartbeat in a loop to keep the framework running
-        * Use the definition of HELENA_ENGINE_NO SLEEP to prevent sleep by 1 ms
+        * Between frames the thread sleeps until the next fixed Update tick (see Context::SetPacing)
+        * Use the definition of HELENA_ENGINE_NOSLEEP to select EPacing::BusyPoll by default
         * The thread will not sleep if your operations consume a lot of CPU time
         */
         [[nodiscard]] static bool Heartbeat();
@@ -341,6 +931,7 @@ namespace Helena
         * @tparam T Type of system
         * @tparam Args Types of arguments
         * @param args Arguments for system initialization
+        * @note The system can declare the accesses for the parallel Update, see Engine::Reads
         */
         template <typename T, typename... Args>
         static void RegisterSystem([[maybe_unused]] Args&&... args);
@@ -434,9 +1025,11 @@ namespace Helena
         * @tparam Event Type of event
         * @tparam Args Types of arguments
         * @param callback Callback function
+        * @return Handle for UnsubscribeEvent
+        * @note The listener already registered is not added again, its handle is returned
         */
         template <typename Event, typename... Args>
-        static void SubscribeEvent(void (*callback)([[maybe_unused]] Args...));
+        static EventHandle SubscribeEvent(void (*callback)([[maybe_unused]] Args...));
 
         /**
         * @brief Listening to the event
@@ -454,9 +1047,11 @@ namespace Helena
         * @tparam System Type of system
         * @tparam Args Types of events
         * @param callback Callback function
+        * @return Handle for UnsubscribeEvent
+        * @note The listener already registered is not added again, its handle is returned
         */
         template <typename Event, typename System, typename... Args>
-        static void SubscribeEvent(void (System::*callback)([[maybe_unused]] Args...));
+        static EventHandle SubscribeEvent(void (System::*callback)([[maybe_unused]] Args...));
 
         /**
         * @brief Trigger an event for all listeners
@@ -473,10 +1068,116 @@ namespace Helena
         * @tparam Event Type of event
         * @tparam Args Types of arguments
         * @param args Arguments for construct the event
+        * @note The event is constructed once and passed to all listeners by reference,
+        * listeners can take the event by value or by const reference (required for move-only events)
         */
         template <typename Event, typename... Args>
+        requires (!(sizeof...(Args) == 1 && (Traits::SameAS<Event, Traits::RemoveCVR<Args>> && ...)))
         static void SignalEvent([[maybe_unused]] Args&&... args);
 
+        /**
+        * @brief Trigger an event for all listeners
+        *
+        * @code{.cpp}
+        * struct MyEvent {
+        *   std::string text;
+        * };
+        *
+        * const MyEvent event{"Hello"};
+        * Helena::Engine::SignalEvent(event);
+        * @endcode
+        *
+        * @tparam Event Type of event
+        * @param event Event object, it is passed to the listeners by reference without copying
+        */
+        template <typename Event>
+        static void SignalEvent(const Event& event);
+
+        /**
+        * @brief Queue the event, the listeners are triggered later by the flush
+        *
+        * @code{.cpp}
+        * struct Damage {
+        *   std::uint32_t target;
+        *   float amount;
+        * };
+        *
+        * // Called 50k times from the system update: no nested dispatches
+        * Helena::Engine::EnqueueEvent<Damage>(target, 10.f);
+        * @endcode
+        *
+        * @tparam Event Type of event
+        * @tparam Args Types of arguments
+        * @param args Arguments for construct the event
+        * @note
+        * The events are stored in the contiguous buffer of the event type and flushed
+        * in the Heartbeat phase selected by Context::SetEventFlush or by Engine::FlushEvents.
+        * Each listener is invoked over the whole batch in the order of the enqueue,
+        * events enqueued by the listeners during the flush are delivered by the next flush.
+        * @warning Not thread safe, the engine events can't be queued
+        */
+        template <typename Event, typename... Args>
+        static void EnqueueEvent([[maybe_unused]] Args&&... args);
+
+        /**
+        * @brief Post the event to the engine thread (thread safe)
+        *
+        * @code{.cpp}
+        * struct PathFound {
+        *   std::uint32_t entity;
+        *   std::uint32_t nodes;
+        * };
+        *
+        * // Worker thread
+        * Helena::Engine::PostEvent<PathFound>(entity, nodes);
+        * @endcode
+        *
+        * @tparam Event Type of event
+        * @tparam Args Types of arguments
+        * @param args Arguments for construct the event
+        * @return False if the post queue stays full and the event is dropped
+        * @note
+        * The event is constructed in the slot of the bounded lock-free queue shared by all event types
+        * and dispatched to the listeners by the engine thread at the beginning of the next Heartbeat frame.
+        * If the queue is full, the producer waits for the engine thread a few times before dropping the event,
+        * see Context::GetPostStats for the overflow and backpressure counters.
+        * The event should fit into 48 bytes, use EnqueueEvent or pass a pointer for larger payloads.
+        * The construction of the event should not throw, construct the event before and post it by move.
+        */
+        template <typename Event, typename... Args>
+        static bool PostEvent([[maybe_unused]] Args&&... args);
+
+        /**
+        * @brief Export the recent frames of the frame profiler as Chrome trace JSON
+        *
+        * @code{.cpp}
+        * Helena::Engine::Context::SetFrameProfiler(true);
+        * // ...
+        * if(frameSpike) {
+        *   Helena::Engine::ExportFrameTrace("frames.json"); // open in ui.perfetto.dev or chrome://tracing
+        * }
+        * @endcode
+        *
+        * @param path Path of the file
+        * @return False if the file can't be written
+        */
+        static bool ExportFrameTrace(const std::filesystem::path& path);
+
+        /**
+        * @brief Returns the dispatch time of the events and their listeners
+        * @return Event types sorted by the total time
+        * @note
+        * Requires HELENA_ENGINE_EVENT_STATS, otherwise the result is empty and the dispatch is not instrumented.
+        * With HELENA_ENGINE_EVENT_STATS the sorted report is also printed at Shutdown.
+        */
+        [[nodiscard]] static std::vector<EventStats> GetEventStats();
+
+        /**
+        * @brief Trigger the listeners of all queued events
+        * @note Called by the Heartbeat in the phase selected by Context::SetEventFlush, not reentrant
+        */
+        static void FlushEvents();
+
         /**
         * @brief Stop listening to the event
         * 
@@ -517,6 +1218,152 @@ namespace Helena
         */
         template <typename Event, typename System, typename... Args>
         static void UnsubscribeEvent(void (System::*callback)([[maybe_unused]] Args...));
+
+        /**
+        * @brief Stop listening to the event
+        *
+        * @code{.cpp}
+        * const auto handle = Helena::Engine::SubscribeEvent<Helena::Events::Engine::Tick>(&OnTick);
+        * Helena::Engine::UnsubscribeEvent(handle);
+        * @endcode
+        *
+        * @param handle Handle returned by SubscribeEvent
+        * @note
+        * Complexity O(1), stale handles are ignored.
+        * It is safe to unsubscribe during the dispatch: the listener is not called anymore
+        * and the pool is compacted when the dispatch is finished.
+        */
+        static void UnsubscribeEvent(EventHandle handle) noexcept;
+
+        /**
+        * @brief Submit the job to the engine thread pool (thread safe)
+        *
+        * @code{.cpp}
+        * auto future = Helena::Engine::Submit([](int value) {
+        *   return value * 2;
+        * }, 21);
+        *
+        * Helena::Engine::WaitJobs(future);
+        * const auto result = future.get(); // 42
+        * @endcode
+        *
+        * @tparam Func Type of callable object
+        * @tparam Args Types of arguments
+        * @param func Callable object
+        * @param args Arguments passed to the callable object
+        * @return Future with the result of the job
+        * @note All jobs are joined before the Render event and before Shutdown
+        */
+        template <typename Func, typename... Args>
+        requires std::invocable<Func, Args...>
+        [[nodiscard]] static auto Submit(Func&& func, [[maybe_unused]] Args&&... args);
+
+        /**
+        * @brief Execute the function for each index in range [begin, end) on the engine thread pool
+        *
+        * @code{.cpp}
+        * void OnUpdate(const Helena::Events::Engine::Update event) {
+        *   Helena::Engine::ParallelFor(0, m_Entities.size(), [&](std::size_t index) {
+        *       m_Entities[index].Update(event.fixedTime);
+        *   });
+        * }
+        * @endcode
+        *
+        * @tparam Func Type of callable object
+        * @param begin First index
+        * @param end Last index (exclusive)
+        * @param func Callable object with signature void(std::size_t)
+        * @param grain Number of indexes per job, 0 for auto
+        * @note The calling thread participates in execution and returns when all indexes are processed
+        */
+        template <typename Func>
+        requires std::invocable<Func&, std::size_t>
+        static void ParallelFor(std::size_t begin, std::size_t end, Func&& func, std::size_t grain = 0);
+
+        /**
+        * @brief Wait for all jobs submitted to the engine thread pool
+        * @note
+        * The calling thread participates in execution.
+        * Called from a job (e.g. a parallel Update listener), it does not wait for the jobs running on the calling thread
+        * and for the jobs blocked in WaitJobs on other threads.
+        */
+        static void WaitJobs();
+
+        /**
+        * @brief Wait for the job submitted to the engine thread pool
+        * @tparam T Type of job result
+        * @param future Future returned by Submit
+        * @note The calling thread participates in execution
+        */
+        template <typename T>
+        static void WaitJobs(const std::future<T>& future);
+
+        /**
+        * @brief Wake up the engine not later than the time point
+        *
+        * @code{.cpp}
+        * // Wake up the engine in time for the earliest task
+        * Helena::Engine::WakeupAt(scheduler.NextTime());
+        * @endcode
+        *
+        * @param time Time in nanoseconds of Types::Clock
+        * @note The time is used once by the next frame pacing and then reset
+        */
+        static void WakeupAt(std::uint64_t time) noexcept;
+
+        /**
+        * @brief Suspend the coroutine for the delay
+        *
+        * @code{.cpp}
+        * Helena::Types::Coroutine Respawn(Entity entity) {
+        *   co_await Helena::Engine::Delay(std::chrono::seconds{5});
+        *   Spawn(entity);
+        * }
+        * @endcode
+        *
+        * @param delay Delay (std::chrono::milliseconds, seconds, etc.)
+        * @note The coroutine is resumed by the first Tick after the delay, the engine wakes up in time for it
+        */
+        template <typename Rep, typename Period>
+        [[nodiscard]] static Types::CoroutineScheduler::DelayAwaiter Delay(std::chrono::duration<Rep, Period> delay);
+
+        /**
+        * @brief Suspend the coroutine for the delay
+        * @param ms Delay in milliseconds
+        */
+        [[nodiscard]] static Types::CoroutineScheduler::DelayAwaiter Delay(std::uint64_t ms);
+
+        /**
+        * @brief Suspend the coroutine until the next frame
+        * @note The coroutine is resumed after the Tick event of the next frame
+        */
+        [[nodiscard]] static Types::CoroutineScheduler::NextAwaiter NextTick();
+
+        /**
+        * @brief Suspend the coroutine until the next fixed Update tick
+        * @note The coroutine is resumed after the listeners of the Update event
+        */
+        [[nodiscard]] static Types::CoroutineScheduler::NextAwaiter NextUpdate();
+
+        /**
+        * @brief Suspend the coroutine until the event is signaled
+        *
+        * @code{.cpp}
+        * Helena::Types::Coroutine Quest() {
+        *   const auto event = co_await Helena::Engine::WaitEvent<Events::MonsterKilled>();
+        *   Reward(event.player);
+        * }
+        * @endcode
+        *
+        * @tparam Event Type of event
+        * @return Awaiter, co_await returns the copy of the event
+        * @note
+        * The awaiter is subscribed as the listener of the event until the first signal or the queued flush,
+        * the coroutine is resumed by the next Tick (not inside the dispatch of the event).
+        * Coroutines waiting on the events are destroyed by the Shutdown.
+        */
+        template <typename Event>
+        [[nodiscard]] static EventAwaiter<Event> WaitEvent();
     };
 }
 
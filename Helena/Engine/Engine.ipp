@@ -2,9 +2,13 @@
 #define HELENA_ENGINE_ENGINE_IPP
 
 #include <Helena/Engine/Engine.hpp>
+#include <Helena/Traits/AnyOf.hpp>
 #include <Helena/Traits/Arguments.hpp>
+#include <Helena/Traits/Detector.hpp>
+#include <Helena/Traits/NameOf.hpp>
 #include <Helena/Traits/Remove.hpp>
 #include <Helena/Traits/SameAS.hpp>
+#include <Helena/Types/Clock.hpp>
 #include <Helena/Types/DateTime.hpp>
 #include <Helena/Util/Format.hpp>
 #include <Helena/Util/Sleep.hpp>
@@ -103,28 +107,644 @@ namespace Helena
     }
 #endif
 
-    [[nodiscard]] inline bool Engine::Heartbeat()
+    inline void Engine::Pacing(Context& ctx)
+    {
+        if(ctx.m_Pacing == EPacing::BusyPoll) {
+            ctx.m_TimeWakeup = Context::TimeWakeupNone;
+            return;
+        }
+
+        // Next fixed Update tick or the wakeup time requested by the user
+        const auto timeLeft = ctx.m_TickPeriod - (std::min)(ctx.m_TickAccumulator, ctx.m_TickPeriod);
+        const auto timeTick = ctx.m_TimeNow + timeLeft;
+        const auto deadline = (std::min)(timeTick, ctx.m_TimeWakeup);
+        ctx.m_TimeWakeup = Context::TimeWakeupNone;
+
+        // The reactor is opened by the first Heartbeat, or here if the pacing was changed later (without the signalfd)
+        if(ctx.m_Pacing == EPacing::Reactor && ctx.m_Reactor.Open(false))
+        {
+            const auto wakeup = ctx.m_Reactor.Wait(Types::Clock::ToSteady(deadline), [&ctx]() {
+                return ctx.m_Posts.Count() || ctx.m_State != EState::Init;
+            });
+
+            if(wakeup == Types::Reactor::EWakeup::Signal) {
+                Shutdown();
+            }
+
+            if(wakeup != Types::Reactor::EWakeup::Error) {
+                return;
+            }
+        }
+
+        if(ctx.m_Pacing == EPacing::LowPower || ctx.m_Pacing == EPacing::Reactor) {
+            if(Types::Clock::Now() < deadline) {
+                Util::SleepUntil(Types::Clock::ToSteady(deadline));
+            }
+            return;
+        }
+
+        constexpr auto spin = static_cast<std::uint64_t>(std::chrono::nanoseconds{Context::DefaultPacingSpin}.count());
+        if(Types::Clock::Now() + spin < deadline) {
+            Util::SleepUntil(Types::Clock::ToSteady(deadline - spin));
+        }
+
+        while(Types::Clock::Now() < deadline) {
+            HELENA_PROCESSOR_YIELD();
+        }
+    }
+
+    template <typename Event>
+    [[nodiscard]] Engine::EventPool* Engine::FindEventPool(Context& ctx) {
+        const auto index = ctx.m_EventIndexer.template Get<Event>();
+        return index < ctx.m_Events.size() ? ctx.m_Events[index].get() : nullptr;
+    }
+
+    template <typename Event>
+    [[nodiscard]] Engine::EventPool& Engine::GetEventPool(Context& ctx)
+    {
+        const auto index = ctx.m_EventIndexer.template Get<Event>();
+        if(index >= ctx.m_Events.size()) {
+            ctx.m_Events.resize(index + 1);
+        }
+
+        auto& pool = ctx.m_Events[index];
+        if(!pool) {
+            pool = std::make_unique<EventPool>();
+        #if defined(HELENA_ENGINE_EVENT_STATS)
+            pool->m_Name = Traits::NameOf<Event>::value;
+        #endif
+        }
+
+        return *pool;
+    }
+
+    inline void Engine::ClearEvents(Context& ctx) noexcept
+    {
+        // Discard the events posted from other threads
+        while(ctx.m_Posts.TryPop([](PostedEvent&) {})) {}
+
+        ctx.m_EventsQueued.clear();
+
+        for(auto& pool : ctx.m_Events) {
+            if(pool) {
+                ClearListeners(*pool);
+                pool->m_Queue.reset();
+                pool->m_Queued = false;
+            }
+        }
+    }
+
+    template <typename Event, typename Callback>
+    [[nodiscard]] Engine::EventHandle Engine::FindListener(Context& ctx, Callback callback)
+    {
+        const auto* pool = FindEventPool<Event>(ctx);
+        if(!pool) {
+            return EventHandle{};
+        }
+
+        const auto key = CallbackStorage{callback, nullptr}.Key();
+        auto slot = pool->m_Callbacks.Find(key);
+        if(slot != Types::FlatIndex::None && pool->m_Listeners[pool->m_Slots[slot].m_Index] != callback) {
+            slot = Types::FlatIndex::None;
+        }
+
+        // The callback with the colliding key is not indexed
+        if(slot == Types::FlatIndex::None && pool->m_CallbacksCollision)
+        {
+            const auto it = std::find_if(pool->m_Listeners.cbegin(), pool->m_Listeners.cend(), [callback](const auto& storage) {
+                return storage.m_Callback && storage == callback;
+            });
+
+            if(it != pool->m_Listeners.cend()) {
+                slot = pool->m_ListenerSlots[static_cast<std::size_t>(it - pool->m_Listeners.cbegin())];
+            }
+        }
+
+        if(slot == Types::FlatIndex::None) {
+            return EventHandle{};
+        }
+
+        return EventHandle{
+            .m_Pool = static_cast<std::uint32_t>(ctx.m_EventIndexer.template Get<Event>()),
+            .m_Slot = slot,
+            .m_Generation = pool->m_Slots[slot].m_Generation
+        };
+    }
+
+    inline void Engine::IndexListener(EventPool& pool, std::uint32_t slot)
+    {
+        const auto key = pool.m_Listeners[pool.m_Slots[slot].m_Index].Key();
+        if(!pool.m_Callbacks.Insert(key, slot)) {
+            pool.m_CallbacksCollision = true;
+        }
+    }
+
+    template <typename Event, typename System>
+    [[nodiscard]] Engine::EventHandle Engine::AddListener(Context& ctx, CallbackStorage listener)
+    {
+        auto& pool = GetEventPool<Event>(ctx);
+
+        // Subscribe/unsubscribe churn without dispatches
+        if(!pool.m_Depth && pool.m_Tombstones > pool.m_Listeners.size() / 2) {
+            CompactListeners(pool);
+        }
+
+        auto slot = pool.m_SlotFree;
+        if(slot == EventPool::SlotNone) {
+            slot = static_cast<std::uint32_t>(pool.m_Slots.size());
+            pool.m_Slots.emplace_back(EventPool::Slot{.m_Index = 0, .m_Generation = 1});
+        } else {
+            pool.m_SlotFree = pool.m_Slots[slot].m_Index;
+        }
+
+        if constexpr(!std::is_void_v<System>) {
+            listener.m_Access = GetSystemAccess<System>();
+        }
+
+        pool.m_Slots[slot].m_Index = static_cast<std::uint32_t>(pool.m_Listeners.size());
+        pool.m_Listeners.emplace_back(listener);
+        pool.m_ListenerSlots.emplace_back(slot);
+        ++pool.m_Version;
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        // Listeners are keyed by the callback address (first word of the free or member function pointer)
+        std::uintptr_t address{}; std::memcpy(&address, &listener.m_Storage, sizeof(address));
+        std::string_view name{};
+        if constexpr(!std::is_void_v<System>) {
+            name = Traits::NameOf<System>::value;
+        }
+
+        auto it = std::find_if(pool.m_Profiles.begin(), pool.m_Profiles.end(), [address, name](const auto& profile) {
+            return profile->m_Address == address && profile->m_Name == name;
+        });
+
+        if(it == pool.m_Profiles.end()) {
+            it = pool.m_Profiles.insert(it, std::make_unique<EventPool::Profile>(name, address));
+        }
+
+        pool.m_ListenerProfiles.emplace_back(it->get());
+    #endif
+
+        return EventHandle{
+            .m_Pool = static_cast<std::uint32_t>(ctx.m_EventIndexer.template Get<Event>()),
+            .m_Slot = slot,
+            .m_Generation = pool.m_Slots[slot].m_Generation
+        };
+    }
+
+    inline void Engine::RemoveListener(EventPool& pool, std::size_t index) noexcept
+    {
+        const auto slot = pool.m_ListenerSlots[index];
+
+        // The listeners added by AddListener only (e.g. WaitEvent) are not indexed
+        if(const auto key = pool.m_Listeners[index].Key(); pool.m_Callbacks.Find(key) == slot) {
+            pool.m_Callbacks.Erase(key);
+        }
+
+        // Tombstone: the dispatch skips it, CompactListeners removes it
+        pool.m_Listeners[index].m_Callback = nullptr;
+        pool.m_ListenerSlots[index] = EventPool::SlotNone;
+        ++pool.m_Tombstones;
+        ++pool.m_Version;
+
+        // Release the slot, the generation invalidates the handles
+        auto& entry = pool.m_Slots[slot];
+        if(!++entry.m_Generation) {
+            entry.m_Generation = 1;
+        }
+
+        entry.m_Index = pool.m_SlotFree;
+        pool.m_SlotFree = slot;
+    }
+
+    inline void Engine::CompactListeners(EventPool& pool) noexcept
+    {
+        HELENA_ASSERT(!pool.m_Depth, "Compaction during the dispatch");
+
+        std::size_t size = 0;
+        for(std::size_t index = 0; index < pool.m_Listeners.size(); ++index)
+        {
+            if(!pool.m_Listeners[index].m_Callback) {
+                continue;
+            }
+
+            if(size != index) {
+                pool.m_Listeners[size] = pool.m_Listeners[index];
+                pool.m_ListenerSlots[size] = pool.m_ListenerSlots[index];
+                pool.m_Slots[pool.m_ListenerSlots[size]].m_Index = static_cast<std::uint32_t>(size);
+            #if defined(HELENA_ENGINE_EVENT_STATS)
+                pool.m_ListenerProfiles[size] = pool.m_ListenerProfiles[index];
+            #endif
+            }
+
+            ++size;
+        }
+
+        pool.m_Listeners.erase(pool.m_Listeners.begin() + size, pool.m_Listeners.end());
+        pool.m_ListenerSlots.erase(pool.m_ListenerSlots.begin() + size, pool.m_ListenerSlots.end());
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        pool.m_ListenerProfiles.erase(pool.m_ListenerProfiles.begin() + size, pool.m_ListenerProfiles.end());
+    #endif
+        pool.m_Tombstones = 0;
+        ++pool.m_Version;
+    }
+
+    inline void Engine::ClearListeners(EventPool& pool) noexcept
+    {
+        for(std::size_t index = 0; index < pool.m_Listeners.size(); ++index) {
+            if(pool.m_Listeners[index].m_Callback) {
+                RemoveListener(pool, index);
+            }
+        }
+
+        pool.m_CallbacksCollision = false;
+
+        if(!pool.m_Depth) {
+            CompactListeners(pool);
+        }
+    }
+
+    template <typename Event>
+    void Engine::DispatchEvent(EventPool& pool, const void* event)
+    {
+        // Reverse order, listeners subscribed during the dispatch are called by the next one.
+        // Unsubscribed listeners are tombstones: the positions are stable until the compaction
+        auto& eventPool = pool.m_Listeners;
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        const auto timeStart = Types::Clock::Now();
+    #endif
+
+        ++pool.m_Depth;
+        for(std::size_t pos = eventPool.size(); pos; --pos) {
+            if(const auto callback = eventPool[pos - 1].m_Callback) {
+            #if defined(HELENA_ENGINE_EVENT_STATS)
+                ProfileListener(pool, pos - 1, event);
+            #else
+                callback(eventPool[pos - 1], event);
+            #endif
+            }
+        }
+        --pool.m_Depth;
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        pool.m_Time.Record(Types::Clock::Now() - timeStart);
+    #endif
+
+        if constexpr(Traits::IsAnyOf<Event,
+            Events::Engine::Init,
+            Events::Engine::Config,
+            Events::Engine::Execute,
+            Events::Engine::Finalize,
+            Events::Engine::Shutdown>::value) {
+            ClearListeners(pool);
+        } else {
+            if(!pool.m_Depth && pool.m_Tombstones) {
+                CompactListeners(pool);
+            }
+        }
+    }
+
+    template <typename System>
+    [[nodiscard]] const Engine::SystemAccess* Engine::GetSystemAccess() noexcept
+    {
+        if constexpr(Traits::IsDetected<SystemReads, System>::value || Traits::IsDetected<SystemWrites, System>::value)
+        {
+            using ReadsList = Traits::DetectedOrType<Reads<>, SystemReads, System>;
+            using WritesList = Traits::DetectedOrType<Writes<>, SystemWrites, System>;
+            static_assert(Traits::Specialization<ReadsList, Reads>, "System::Reads should be Engine::Reads<...>");
+            static_assert(Traits::Specialization<WritesList, Writes>, "System::Writes should be Engine::Writes<...>");
+
+            // The system writes itself: listeners of the same system are never parallel
+            static constexpr auto writes = [] {
+                std::array<std::uint64_t, WritesList::Keys.size() + 1> keys{Types::Hash<std::uint64_t>::template Get<System>()};
+                std::copy(WritesList::Keys.begin(), WritesList::Keys.end(), keys.begin() + 1);
+                return keys;
+            }();
+
+            static constexpr SystemAccess access{
+                .m_Reads = ReadsList::Keys,
+                .m_Writes = writes,
+                .m_Find = &FindSystem<System>
+            };
+
+            return &access;
+        } else {
+            return nullptr;
+        }
+    }
+
+    template <typename System>
+    [[nodiscard]] void* Engine::FindSystem()
     {
         auto& ctx = Engine::Context::GetInstance();
-        const auto state = ctx.m_State.load(std::memory_order_relaxed);
-        const auto fnGetTimeMS = []() noexcept {
-            std::uint64_t ms {};
-        #if defined(HELENA_PLATFORM_WIN)
-            static LARGE_INTEGER s_frequency;
-            static BOOL s_use_qpc = QueryPerformanceFrequency(&s_frequency);
-            LARGE_INTEGER now;
-            if(s_use_qpc && QueryPerformanceCounter(&now)) {
-                ms = (1000LL * now.QuadPart) / s_frequency.QuadPart;
-            } else {
-                ms = GetTickCount64();
+        return ctx.m_Systems.template Has<System>() ? &ctx.m_Systems.template Get<System>() : nullptr;
+    }
+
+    [[nodiscard]] inline bool Engine::HasConflict(const SystemAccess* lhs, const SystemAccess* rhs) noexcept
+    {
+        if(!lhs || !rhs) {
+            return true;
+        }
+
+        const auto fnIntersect = [](std::span<const std::uint64_t> a, std::span<const std::uint64_t> b) {
+            return std::find_first_of(a.begin(), a.end(), b.begin(), b.end()) != a.end();
+        };
+
+        return fnIntersect(lhs->m_Writes, rhs->m_Writes)
+            || fnIntersect(lhs->m_Writes, rhs->m_Reads)
+            || fnIntersect(lhs->m_Reads, rhs->m_Writes);
+    }
+
+    inline void Engine::BuildUpdateSchedule(Context& ctx, EventPool& pool)
+    {
+        auto& schedule = ctx.m_UpdateSchedule;
+        schedule.m_Listeners.clear();
+        schedule.m_Levels.clear();
+        schedule.m_Version = pool.m_Version;
+        schedule.m_SystemsGeneration = ctx.m_SystemsGeneration;
+        schedule.m_Parallel = false;
+
+        const auto size = pool.m_Listeners.size();
+        std::vector<const SystemAccess*> accesses(size);
+        std::vector<std::uint32_t> levels(size);
+        std::uint32_t levelCount = 0;
+
+        // Dispatch order is reverse: the listener level is next after the last conflicting earlier listener
+        for(std::size_t pos = size; pos; --pos)
+        {
+            auto& listener = pool.m_Listeners[pos - 1];
+            if(!listener.m_Callback) {
+                continue;
+            }
+
+            // Resolve the system on the engine thread, the parallel listeners never touch the context.
+            // Removed system: the listener unsubscribes itself, it has to be serial
+            if(const auto* access = listener.m_Access) {
+                if(auto* system = access->m_Find()) {
+                    listener.m_System = system;
+                    listener.m_SystemsGeneration = ctx.m_SystemsGeneration;
+                    accesses[pos - 1] = access;
+                }
             }
+
+            std::uint32_t level = 0;
+            for(auto prev = size; prev > pos; --prev) {
+                if(pool.m_Listeners[prev - 1].m_Callback && levels[prev - 1] >= level
+                    && HasConflict(accesses[pos - 1], accesses[prev - 1])) {
+                    level = levels[prev - 1] + 1;
+                }
+            }
+
+            levels[pos - 1] = level;
+            levelCount = (std::max)(levelCount, level + 1);
+        }
+
+        // Group by level, the dispatch order is kept inside the level
+        schedule.m_Levels.resize(levelCount);
+        for(std::size_t pos = size; pos; --pos) {
+            if(pool.m_Listeners[pos - 1].m_Callback) {
+                ++schedule.m_Levels[levels[pos - 1]];
+            }
+        }
+
+        std::uint32_t offset = 0;
+        for(auto& level : schedule.m_Levels) {
+            schedule.m_Parallel = schedule.m_Parallel || level > 1;
+            offset += level;
+            level = offset - level;
+        }
+
+        schedule.m_Listeners.resize(offset);
+        for(std::size_t pos = size; pos; --pos) {
+            if(pool.m_Listeners[pos - 1].m_Callback) {
+                schedule.m_Listeners[schedule.m_Levels[levels[pos - 1]]++] = static_cast<std::uint32_t>(pos - 1);
+            }
+        }
+    }
+
+    inline void Engine::InvokeListener(EventPool& pool, std::size_t index, const void* event)
+    {
+        if(const auto callback = pool.m_Listeners[index].m_Callback) {
+        #if defined(HELENA_ENGINE_EVENT_STATS)
+            ProfileListener(pool, index, event);
         #else
-            struct timeval te;
-            gettimeofday(&te, NULL);
-            ms = te.tv_sec * 1000LL + te.tv_usec / 1000;
+            callback(pool.m_Listeners[index], event);
         #endif
-            return ms;
-        };
+        }
+    }
+
+    inline void Engine::DispatchUpdate(Context& ctx, const Events::Engine::Update& event)
+    {
+        auto* pool = FindEventPool<Events::Engine::Update>(ctx);
+        if(!pool || pool->m_Listeners.empty()) {
+            return;
+        }
+
+        auto& schedule = ctx.m_UpdateSchedule;
+        const auto outdated = schedule.m_Version != pool->m_Version || schedule.m_SystemsGeneration != ctx.m_SystemsGeneration;
+        if(outdated && !pool->m_Depth) {
+            BuildUpdateSchedule(ctx, *pool);
+        }
+
+        // Nothing to run in parallel or the nested dispatch: the order of SignalEvent
+        if(!schedule.m_Parallel || pool->m_Depth) {
+            DispatchEvent<Events::Engine::Update>(*pool, static_cast<const void*>(&event));
+            return;
+        }
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        const auto timeStart = Types::Clock::Now();
+    #endif
+
+        // Positions are stable during the dispatch: unsubscribed listeners are tombstones,
+        // listeners subscribed by the serial levels are called by the next dispatch
+        ++pool->m_Depth;
+        std::uint32_t begin = 0;
+        for(const auto end : schedule.m_Levels)
+        {
+            // Systems were registered or removed by the listener: the cached systems are stale, the rest is serial
+            if(end - begin > 1 && schedule.m_SystemsGeneration == ctx.m_SystemsGeneration) {
+                ctx.m_Jobs.ParallelFor(begin, end, [pool, &schedule, &event](std::size_t pos) {
+                    InvokeListener(*pool, schedule.m_Listeners[pos], static_cast<const void*>(&event));
+                }, 1);
+            } else {
+                for(auto pos = begin; pos < end; ++pos) {
+                    InvokeListener(*pool, schedule.m_Listeners[pos], static_cast<const void*>(&event));
+                }
+            }
+
+            begin = end;
+        }
+        --pool->m_Depth;
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        pool->m_Time.Record(Types::Clock::Now() - timeStart);
+    #endif
+
+        if(!pool->m_Depth && pool->m_Tombstones) {
+            CompactListeners(*pool);
+        }
+    }
+
+#if defined(HELENA_ENGINE_EVENT_STATS)
+    inline void Engine::ProfileListener(EventPool& pool, std::size_t index, const void* event)
+    {
+        // The listener can grow the pool (subscribe), take the profile before the call
+        auto* profile = pool.m_ListenerProfiles[index];
+        const auto timeStart = Types::Clock::Now();
+        pool.m_Listeners[index].m_Callback(pool.m_Listeners[index], event);
+        profile->m_Time.Record(Types::Clock::Now() - timeStart);
+    }
+
+    inline void Engine::LogEventStats()
+    {
+        const auto stats = GetEventStats();
+        if(stats.empty()) {
+            return;
+        }
+
+        HELENA_MSG_NOTICE("Event stats (sorted by total time)");
+        for(const auto& event : stats)
+        {
+            HELENA_MSG_NOTICE("{} | count: {} | total: {:.3f} ms | max: {:.3f} us | p99: {:.3f} us",
+                event.m_Name, event.m_Count, event.m_Total / 1'000'000.0, event.m_Max / 1'000.0, event.m_P99 / 1'000.0);
+
+            for(const auto& listener : event.m_Listeners) {
+                HELENA_MSG_NOTICE("    {} {:#x} | count: {} | total: {:.3f} ms | max: {:.3f} us | p99: {:.3f} us",
+                    listener.m_Name.empty() ? std::string_view{"function"} : listener.m_Name, listener.m_Address,
+                    listener.m_Count, listener.m_Total / 1'000'000.0, listener.m_Max / 1'000.0, listener.m_P99 / 1'000.0);
+            }
+        }
+    }
+#endif
+
+    template <typename Event>
+    void Engine::FlushEventQueue(EventPool& pool, bool dispatch)
+    {
+        auto& queue = *static_cast<EventQueue<Event>*>(pool.m_Queue.get());
+
+        // Swap the buffers: events enqueued by the listeners wait for the next flush
+        if(!dispatch) {
+            std::swap(queue.m_Pending, queue.m_Flushing);
+            pool.m_Queued = false;
+            return;
+        }
+
+        // Listener-outer loop: each listener runs over the whole batch
+        auto& eventPool = pool.m_Listeners;
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        const auto timeStart = Types::Clock::Now();
+    #endif
+
+        ++pool.m_Depth;
+        for(std::size_t pos = eventPool.size(); pos; --pos)
+        {
+            for(const auto& event : queue.m_Flushing)
+            {
+                // The listener was unsubscribed during the batch
+                const auto callback = eventPool[pos - 1].m_Callback;
+                if(!callback) [[unlikely]] {
+                    break;
+                }
+
+                const auto data = std::is_empty_v<Event> ? nullptr : static_cast<const void*>(&event);
+            #if defined(HELENA_ENGINE_EVENT_STATS)
+                ProfileListener(pool, pos - 1, data);
+            #else
+                callback(eventPool[pos - 1], data);
+            #endif
+            }
+        }
+        --pool.m_Depth;
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        pool.m_Time.Record(Types::Clock::Now() - timeStart);
+    #endif
+
+        if(!pool.m_Depth && pool.m_Tombstones) {
+            CompactListeners(pool);
+        }
+
+        queue.m_Flushing.clear();
+    }
+
+    template <typename Event>
+    void Engine::PostedEventFunction(std::byte* storage, bool dispatch)
+    {
+        auto* event = std::launder(reinterpret_cast<Event*>(storage));
+        if(!dispatch) {
+            std::destroy_at(event);
+            return;
+        }
+
+        if(auto* pool = FindEventPool<Event>(Engine::Context::GetInstance())) {
+            DispatchEvent<Event>(*pool, static_cast<const void*>(event));
+        }
+    }
+
+    inline void Engine::DrainPostedEvents(Context& ctx)
+    {
+        // Only the events posted before the drain: producers can't hold the engine thread here
+        const auto count = ctx.m_Posts.Count();
+        ctx.m_PostHighWater = (std::max)(ctx.m_PostHighWater, static_cast<std::uint64_t>(count));
+
+        for(std::size_t index = 0; index < count; ++index)
+        {
+            const auto dispatched = ctx.m_Posts.TryPop([](PostedEvent& event) {
+                event.m_Function(event.m_Storage, true);
+            });
+
+            // The producer has claimed the slot but has not finished the construction yet
+            if(!dispatched) {
+                break;
+            }
+
+            ++ctx.m_PostDispatched;
+        }
+    }
+
+    inline void Engine::FixedUpdate(Context& ctx)
+    {
+        ctx.m_TickAccumulator += ctx.m_TimeNow - ctx.m_TimePrev;
+
+        const auto due = ctx.m_TickAccumulator / ctx.m_TickPeriod;
+        const auto steps = (std::min)(due, static_cast<std::uint64_t>(ctx.m_TickMaxSteps));
+
+        for(std::uint64_t step = 0; step < steps; ++step)
+        {
+            // More than one tick is due: this tick is executed behind schedule
+            if(due - step > 1) {
+                ++ctx.m_TickStats.m_Late;
+            }
+
+            ctx.m_TickAccumulator -= ctx.m_TickPeriod;
+            ++ctx.m_TickStats.m_Executed;
+
+            const auto timeUpdate = ctx.m_FrameProfiling ? Types::Clock::Now() : 0;
+            DispatchUpdate(ctx, Events::Engine::Update{ctx.m_Tickrate});
+            ctx.m_Coroutines.Update();
+
+            if(ctx.m_FrameProfiling) {
+                ctx.m_FrameProfiler.Record("Update", timeUpdate, Types::Clock::Now());
+            }
+
+            if(ctx.m_EventFlush == EEventFlush::AfterUpdate) {
+                FlushEvents();
+            }
+        }
+
+        const auto left = due - steps;
+        const auto skipped = ctx.m_TickPolicy == ETickPolicy::Drop ? left
+            : left - (std::min)(left, static_cast<std::uint64_t>(ctx.m_TickMaxBacklog));
+
+        ctx.m_TickAccumulator -= skipped * ctx.m_TickPeriod;
+        ctx.m_TickStats.m_Skipped += skipped;
+    }
+
+    [[nodiscard]] inline bool Engine::Heartbeat()
+    {
+        auto& ctx = Engine::Context::GetInstance();
+        const auto state = ctx.m_State.load(std::memory_order_relaxed);
 
     #if defined(HELENA_PLATFORM_WIN)
         __try {
@@ -135,13 +755,21 @@ namespace Helena
             {
                 RegisterHandlers();
 
+                // Before the job workers: they inherit the blocked signals of the signalfd
+                if(ctx.m_Pacing == EPacing::Reactor && !ctx.m_Reactor.Open(true)) {
+                    HELENA_MSG_WARNING("Reactor pacing is not available, LowPower pacing is used");
+                }
+
                 ctx.m_ShutdownMessage.m_Location = {};
                 ctx.m_ShutdownMessage.m_Message.clear();
 
                 ctx.m_State     = Engine::EState::Init;
-                ctx.m_TimeStart = fnGetTimeMS();
+                ctx.m_TimeStart = Types::Clock::Now();
                 ctx.m_TimeNow   = ctx.m_TimeStart;
                 ctx.m_TimePrev  = ctx.m_TimeStart;
+                ctx.m_TickAccumulator = 0;
+
+                ctx.m_Jobs.Start(ctx.m_JobWorkers);
 
                 if(ctx.m_Callback) {
                     ctx.m_Callback();
@@ -156,36 +784,61 @@ namespace Helena
             case Engine::EState::Init: [[likely]]
             {
                 ctx.m_TimePrev  = ctx.m_TimeNow;
-                ctx.m_TimeNow   = fnGetTimeMS();
-                ctx.m_DeltaTime = (ctx.m_TimeNow - ctx.m_TimePrev) / 1000.f;
-
-                ctx.m_TimeElapsed += ctx.m_DeltaTime;
-
-                static std::uint32_t accumulator = 0;
-                static constexpr std::uint32_t accumulatorMax = 2;
+                ctx.m_TimeNow   = Types::Clock::Now();
+                ctx.m_DeltaTime = (ctx.m_TimeNow - ctx.m_TimePrev) / 1'000'000'000.f;
 
                 // Base signal called only once for new listeners
                 SignalEvent<Events::Engine::Init>();
                 SignalEvent<Events::Engine::Config>();
                 SignalEvent<Events::Engine::Execute>();
+
+                DrainPostedEvents(ctx);
+
+                if(ctx.m_FrameProfiling) {
+                    ctx.m_FrameProfiler.Begin(ctx.m_TimeNow);
+                }
+
+                const auto timeTick = ctx.m_FrameProfiling ? Types::Clock::Now() : 0;
                 SignalEvent<Events::Engine::Tick>(ctx.m_DeltaTime);
+                ctx.m_Coroutines.Tick(ctx.m_TimeNow);
 
-                while(ctx.m_TimeElapsed >= ctx.m_Tickrate)
-                {
-                    ctx.m_TimeElapsed -= ctx.m_Tickrate;
-                    if(accumulatorMax < accumulator++) {
-                        accumulator = 0;
-                        break;
-                    }
+                if(ctx.m_FrameProfiling) {
+                    ctx.m_FrameProfiler.Record("Tick", timeTick, Types::Clock::Now());
+                }
 
-                    SignalEvent<Events::Engine::Update>(ctx.m_Tickrate);
+                if(ctx.m_EventFlush == EEventFlush::AfterTick) {
+                    FlushEvents();
                 }
 
-                SignalEvent<Events::Engine::Render>(ctx.m_TimeElapsed / ctx.m_Tickrate);
+                FixedUpdate(ctx);
 
-            #ifndef HELENA_ENGINE_NOSLEEP
-                Util::Sleep(std::chrono::milliseconds{1});
-            #endif
+                // Join the jobs fanned out by listeners before Render
+                ctx.m_Jobs.Wait();
+
+                if(ctx.m_EventFlush == EEventFlush::BeforeRender) {
+                    FlushEvents();
+                }
+
+                const auto timeRender = ctx.m_FrameProfiling ? Types::Clock::Now() : 0;
+                // Interpolation alpha: the fraction of the next tick, the Dilate policy keeps whole ticks in the accumulator
+                SignalEvent<Events::Engine::Render>(static_cast<float>(ctx.m_TickAccumulator % ctx.m_TickPeriod) / ctx.m_TickPeriod);
+
+                if(ctx.m_FrameProfiling) {
+                    ctx.m_FrameProfiler.Record("Render", timeRender, Types::Clock::Now());
+                }
+
+                const auto timeSleep = ctx.m_FrameProfiling ? Types::Clock::Now() : 0;
+                if(Running()) {
+                    // Wake up in time for the earliest coroutine delay
+                    ctx.m_TimeWakeup = (std::min)(ctx.m_TimeWakeup, ctx.m_Coroutines.NextTime());
+                    Pacing(ctx);
+                }
+
+                if(ctx.m_FrameProfiling) {
+                    const auto timeEnd = Types::Clock::Now();
+                    ctx.m_FrameProfiler.Record("Sleep", timeSleep, timeEnd);
+                    ctx.m_FrameProfiler.End(timeEnd);
+                }
 
             } break;
 
@@ -194,8 +847,16 @@ namespace Helena
                 SignalEvent<Events::Engine::Finalize>();
                 SignalEvent<Events::Engine::Shutdown>();
 
-                ctx.m_Events.Clear();
+            #if defined(HELENA_ENGINE_EVENT_STATS)
+                LogEventStats();
+            #endif
+
+                ctx.m_Jobs.Stop();
+                ctx.m_Reactor.Close();
+                ctx.m_Coroutines.Clear();
+                ClearEvents(ctx);
                 ctx.m_Systems.Clear();
+                ++ctx.m_SystemsGeneration;
                 ctx.m_State = Engine::EState::Undefined;
 
                 if(!ctx.m_ShutdownMessage.m_Message.empty())
@@ -253,6 +914,9 @@ namespace Helena
                 ctx.m_ShutdownMessage.m_Location = msg.m_Location;
                 ctx.m_ShutdownMessage.m_Message = Util::Format(msg.m_Msg, std::forward<Args>(args)...);
             }
+
+            // Shutdown from other thread: wake up the engine thread blocked in the reactor
+            ctx.m_Reactor.Notify();
         }
     }
 
@@ -269,7 +933,9 @@ namespace Helena
 
     template <typename T, typename... Args>
     void Engine::RegisterSystem([[maybe_unused]] Args&&... args) {
-        Engine::Context::GetInstance().m_Systems.template Create<T>(std::forward<Args>(args)...);
+        auto& ctx = Engine::Context::GetInstance();
+        ctx.m_Systems.template Create<T>(std::forward<Args>(args)...);
+        ++ctx.m_SystemsGeneration;
     }
 
     template <typename... T>
@@ -289,156 +955,408 @@ namespace Helena
 
     template <typename... T>
     void Engine::RemoveSystem() {
-        Engine::Context::GetInstance().m_Systems.template Remove<T...>();
+        auto& ctx = Engine::Context::GetInstance();
+        ctx.m_Systems.template Remove<T...>();
+        ++ctx.m_SystemsGeneration;
     }
 
     template <typename Event, typename... Args>
-    void Engine::SubscribeEvent(void (*callback)([[maybe_unused]] Args...))
+    Engine::EventHandle Engine::SubscribeEvent(void (*callback)([[maybe_unused]] Args...))
     {
         static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
 
         auto& ctx = Engine::Context::GetInstance();
-        if(!ctx.m_Events.template Has<Event>()) {
-            ctx.m_Events.template Create<Event>();
-        }
 
-        auto& eventPool = ctx.m_Events.template Get<Event>();
-        const auto empty = eventPool.cend() == std::find_if(eventPool.begin(), eventPool.end(), [callback](const auto& storage) {
-            return storage == callback;
-        });
-        HELENA_ASSERT(empty, "Listener already registered!");
+        // The listener already registered keeps its handle
+        if(const auto existing = FindListener<Event>(ctx, callback)) {
+            return existing;
+        }
 
-        if(empty)
-        {
-            eventPool.emplace_back(callback, +[](CallbackStorage::Storage& storage, [[maybe_unused]] void* data) 
+        const auto handle = AddListener<Event>(ctx, CallbackStorage{callback, +[](CallbackStorage& listener, [[maybe_unused]] const void* data) 
             {
                 if constexpr(std::is_empty_v<Event>) {
                     static_assert(Traits::Arguments<Args...>::Orphan, "Args should be dropped for optimization");
 
-                    storage.m_Callback();
+                    listener.m_Storage.m_Callback();
                 } else {
                     static_assert(Traits::Arguments<Args...>::Single, "Args incorrect");
                     static_assert((Traits::SameAS<Event, Traits::RemoveCVR<Args>> && ...), "Args type incorrect");
+                    static_assert((IsEventArgument<Event, Args> && ...), "Event should be taken by value or by const reference");
 
-                    decltype(callback) fn{}; new (&fn) decltype(storage.m_Callback){storage.m_Callback};
-                    fn(*static_cast<Traits::RemoveCVR<typename Traits::Arguments<Args...>::template Get<0>>*>(data));
+                    decltype(callback) fn{}; new (&fn) decltype(listener.m_Storage.m_Callback){listener.m_Storage.m_Callback};
+                    fn(*static_cast<const Event*>(data));
                 }
-            });
-        }
+            }});
+
+        IndexListener(*ctx.m_Events[handle.m_Pool], handle.m_Slot);
+        return handle;
     }
 
     template <typename Event, typename System, typename... Args>
-    void Engine::SubscribeEvent(void (System::*callback)([[maybe_unused]] Args...))
+    Engine::EventHandle Engine::SubscribeEvent(void (System::*callback)([[maybe_unused]] Args...))
     {
         static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
 
         auto& ctx = Engine::Context::GetInstance();
-        if(!ctx.m_Events.template Has<Event>()) {
-            ctx.m_Events.template Create<Event>();
-        }
 
-        auto& eventPool = ctx.m_Events.template Get<Event>();
-        const auto empty = eventPool.cend() == std::find_if(eventPool.begin(), eventPool.end(), [callback](const auto& storage) {
-            return storage == callback;
-        });
-        HELENA_ASSERT(empty, "Listener already registered!");
+        // The listener already registered keeps its handle
+        if(const auto existing = FindListener<Event>(ctx, callback)) {
+            return existing;
+        }
 
-        if(empty)
-        {
-            eventPool.emplace_back(callback, +[](CallbackStorage::Storage& storage, [[maybe_unused]] void* data) 
+        const auto handle = AddListener<Event, System>(ctx, CallbackStorage{callback, +[](CallbackStorage& listener, [[maybe_unused]] const void* data) 
             {
-                auto& ctx = Engine::Context::GetInstance();
-                if(!ctx.m_Systems.template Has<System>()) [[unlikely]] {
-                    decltype(callback) fn{}; new (&fn) decltype(storage.m_CallbackMember){storage.m_CallbackMember};
-                    UnsubscribeEvent<Event>(fn);
-                    return;
+                decltype(callback) fn{}; new (&fn) decltype(listener.m_Storage.m_CallbackMember){listener.m_Storage.m_CallbackMember};
+
+                // Resolve the system only when the set of systems was changed
+                if(auto& ctx = Engine::Context::GetInstance(); listener.m_SystemsGeneration != ctx.m_SystemsGeneration) [[unlikely]]
+                {
+                    if(!ctx.m_Systems.template Has<System>()) {
+                        UnsubscribeEvent<Event>(fn);
+                        return;
+                    }
+
+                    listener.m_System = &ctx.m_Systems.template Get<System>();
+                    listener.m_SystemsGeneration = ctx.m_SystemsGeneration;
                 }
 
                 if constexpr(std::is_empty_v<Event>) {
                     static_assert(Traits::Arguments<Args...>::Orphan, "Args should be dropped for optimization");
 
-                    decltype(callback) fn{}; new (&fn) decltype(storage.m_CallbackMember){storage.m_CallbackMember};
-                    (ctx.m_Systems.template Get<System>().*fn)();
+                    (static_cast<System*>(listener.m_System)->*fn)();
                 } else {
                     static_assert(Traits::Arguments<Args...>::Single, "Args incorrect");
-                    static_assert((Traits::SameAS<Event, Traits::RemoveCVRP<Args>> && ...), "Args type incorrect");
+                    static_assert((Traits::SameAS<Event, Traits::RemoveCVR<Args>> && ...), "Args type incorrect");
+                    static_assert((IsEventArgument<Event, Args> && ...), "Event should be taken by value or by const reference");
 
-                    decltype(callback) fn{}; new (&fn) decltype(storage.m_CallbackMember){storage.m_CallbackMember};
-                    (ctx.m_Systems.template Get<System>().*fn)(*static_cast<Traits::RemoveCVR<typename Traits::Arguments<Args...>::template Get<0>>*>(data));
+                    (static_cast<System*>(listener.m_System)->*fn)(*static_cast<const Event*>(data));
                 }
-            });
-        }
+            }});
+
+        IndexListener(*ctx.m_Events[handle.m_Pool], handle.m_Slot);
+        return handle;
     }
 
     template <typename Event, typename... Args>
+    requires (!(sizeof...(Args) == 1 && (Traits::SameAS<Event, Traits::RemoveCVR<Args>> && ...)))
     void Engine::SignalEvent([[maybe_unused]] Args&&... args)
     {
         static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
 
+        auto* pool = FindEventPool<Event>(Engine::Context::GetInstance());
+        if(!pool || pool->m_Listeners.empty()) {
+            return;
+        }
+
+        // The event is constructed once: the listeners share it by reference
+        if constexpr(std::is_empty_v<Event>) {
+            DispatchEvent<Event>(*pool, nullptr);
+        } else if constexpr(std::is_aggregate_v<Event>) {
+            const auto event = Event{std::forward<Args>(args)...};
+            DispatchEvent<Event>(*pool, static_cast<const void*>(&event));
+        } else {
+            const auto event = Event(std::forward<Args>(args)...);
+            DispatchEvent<Event>(*pool, static_cast<const void*>(&event));
+        }
+    }
+
+    template <typename Event>
+    void Engine::SignalEvent(const Event& event)
+    {
+        static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
+
+        if(auto* pool = FindEventPool<Event>(Engine::Context::GetInstance())) {
+            DispatchEvent<Event>(*pool, static_cast<const void*>(&event));
+        }
+    }
+
+    template <typename Event, typename... Args>
+    void Engine::EnqueueEvent([[maybe_unused]] Args&&... args)
+    {
+        static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
+        static_assert(!Traits::IsAnyOf<Event,
+            Events::Engine::Init,
+            Events::Engine::Config,
+            Events::Engine::Execute,
+            Events::Engine::Tick,
+            Events::Engine::Update,
+            Events::Engine::Render,
+            Events::Engine::Finalize,
+            Events::Engine::Shutdown>::value, "Engine events can't be queued");
+
+        auto& ctx = Engine::Context::GetInstance();
+        auto& pool = GetEventPool<Event>(ctx);
+        if(!pool.m_Queue) {
+            pool.m_Queue = {new EventQueue<Event>{}, +[](void* queue) noexcept {
+                delete static_cast<EventQueue<Event>*>(queue);
+            }};
+            pool.m_Flush = &FlushEventQueue<Event>;
+        }
+
+        auto& queue = static_cast<EventQueue<Event>*>(pool.m_Queue.get())->m_Pending;
+        if constexpr(std::is_empty_v<Event>) {
+            queue.emplace_back();
+        } else if constexpr(std::is_aggregate_v<Event>) {
+            queue.emplace_back(Event{std::forward<Args>(args)...});
+        } else {
+            queue.emplace_back(std::forward<Args>(args)...);
+        }
+
+        if(!pool.m_Queued) {
+            pool.m_Queued = true;
+            ctx.m_EventsQueued.emplace_back(&pool);
+        }
+    }
+
+    template <typename Event, typename... Args>
+    bool Engine::PostEvent([[maybe_unused]] Args&&... args)
+    {
+        static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
+        static_assert(sizeof(Event) <= PostedEvent::Capacity, "Event is too large for the post queue, pass a pointer or use EnqueueEvent");
+        static_assert(alignof(Event) <= alignof(void*), "Event alignment is too large for the post queue");
+
+        // The slot is claimed before the construction: the construction should not throw
+        if constexpr(std::is_aggregate_v<Event>) {
+            static_assert(noexcept(Event{std::declval<Args>()...}), "Event construction can throw, construct it before the post");
+        } else {
+            static_assert(std::is_nothrow_constructible_v<Event, Args...>, "Event construction can throw, construct it before the post");
+        }
+
         auto& ctx = Engine::Context::GetInstance();
-        if(ctx.m_Events.template Has<Event>())
+        for(std::uint32_t retry = 0;; ++retry)
         {
-            auto& eventPool = ctx.m_Events.template Get<Event>();
-            for(std::size_t pos = eventPool.size(); pos; --pos)
-            {
-                if constexpr(std::is_empty_v<Event>) {
-                    eventPool[pos - 1].m_Callback(eventPool[pos - 1].m_Storage, nullptr);
-                } else if constexpr(std::is_aggregate_v<Event>) {
-                    auto event = Event{std::forward<Args>(args)...};
-                    eventPool[pos - 1].m_Callback(eventPool[pos - 1].m_Storage, static_cast<void*>(&event));
-                } else {
-                    auto event = Event(std::forward<Args>(args)...);
-                    eventPool[pos - 1].m_Callback(eventPool[pos - 1].m_Storage, static_cast<void*>(&event));
-                }
+            // Arguments are consumed only when the slot is claimed
+            if(ctx.m_Posts.TryPush(std::in_place_type<Event>, std::forward<Args>(args)...)) {
+                ctx.m_Reactor.Notify();
+                return true;
             }
 
-            if constexpr(Traits::IsAnyOf<Event,
-                Events::Engine::Init,
-                Events::Engine::Config,
-                Events::Engine::Execute,
-                Events::Engine::Finalize,
-                Events::Engine::Shutdown>::value) {
-                eventPool.clear();
+            if(!retry) {
+                ctx.m_PostBackpressure.fetch_add(1, std::memory_order_relaxed);
             }
+
+            if(retry == Context::PostRetries) {
+                ctx.m_PostOverflow.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            }
+
+            std::this_thread::yield();
         }
     }
 
-    template <typename Event, typename... Args>
-    void Engine::UnsubscribeEvent(void (*callback)([[maybe_unused]] Args...)) {
-        static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
+    inline bool Engine::ExportFrameTrace(const std::filesystem::path& path) {
+        return Engine::Context::GetInstance().m_FrameProfiler.ExportChromeTrace(path);
+    }
 
+    [[nodiscard]] inline std::vector<Engine::EventStats> Engine::GetEventStats()
+    {
+        std::vector<EventStats> stats;
+
+    #if defined(HELENA_ENGINE_EVENT_STATS)
+        const auto& ctx = Engine::Context::GetInstance();
+        for(const auto& pool : ctx.m_Events)
+        {
+            if(!pool || !pool->m_Time.Count()) {
+                continue;
+            }
+
+            auto& event = stats.emplace_back(EventStats{
+                .m_Name = pool->m_Name,
+                .m_Count = pool->m_Time.Count(),
+                .m_Total = pool->m_Time.Total(),
+                .m_Max = pool->m_Time.Max(),
+                .m_P99 = pool->m_Time.Percentile(99.0),
+                .m_Listeners = {}
+            });
+
+            for(const auto& profile : pool->m_Profiles)
+            {
+                if(!profile->m_Time.Count()) {
+                    continue;
+                }
+
+                event.m_Listeners.emplace_back(EventListenerStats{
+                    .m_Name = profile->m_Name,
+                    .m_Address = profile->m_Address,
+                    .m_Count = profile->m_Time.Count(),
+                    .m_Total = profile->m_Time.Total(),
+                    .m_Max = profile->m_Time.Max(),
+                    .m_P99 = profile->m_Time.Percentile(99.0)
+                });
+            }
+
+            std::sort(event.m_Listeners.begin(), event.m_Listeners.end(), [](const auto& lhs, const auto& rhs) {
+                return lhs.m_Total > rhs.m_Total;
+            });
+        }
+
+        std::sort(stats.begin(), stats.end(), [](const auto& lhs, const auto& rhs) {
+            return lhs.m_Total > rhs.m_Total;
+        });
+    #endif
+
+        return stats;
+    }
+
+    inline void Engine::FlushEvents()
+    {
         auto& ctx = Engine::Context::GetInstance();
-        if(!ctx.m_Events.template Has<Event>()) {
+        HELENA_ASSERT(ctx.m_EventsFlushing.empty(), "FlushEvents is not reentrant!");
+        if(!ctx.m_EventsFlushing.empty()) {
             return;
         }
 
-        auto& eventPool = ctx.m_Events.template Get<Event>();
-        const auto it = std::find_if(eventPool.cbegin(), eventPool.cend(), [callback](const auto& storage) noexcept {
-            return storage == callback;
-        });
+        // The buffers of all pools are swapped before the dispatch:
+        // events enqueued by the listeners during the flush wait for the next flush regardless of the order of pools
+        std::swap(ctx.m_EventsQueued, ctx.m_EventsFlushing);
+        for(auto* pool : ctx.m_EventsFlushing) {
+            pool->m_Flush(*pool, false);
+        }
 
-        if(it != eventPool.cend()) {
-            eventPool.erase(it);
+        for(auto* pool : ctx.m_EventsFlushing) {
+            pool->m_Flush(*pool, true);
         }
+
+        ctx.m_EventsFlushing.clear();
+    }
+
+    template <typename Event, typename... Args>
+    void Engine::UnsubscribeEvent(void (*callback)([[maybe_unused]] Args...)) {
+        static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
+
+        UnsubscribeEvent(FindListener<Event>(Engine::Context::GetInstance(), callback));
     }
 
     template <typename Event, typename System, typename... Args>
     void Engine::UnsubscribeEvent(void (System::* callback)([[maybe_unused]] Args...)) {
         static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
 
+        UnsubscribeEvent(FindListener<Event>(Engine::Context::GetInstance(), callback));
+    }
+
+    inline void Engine::UnsubscribeEvent(EventHandle handle) noexcept
+    {
         auto& ctx = Engine::Context::GetInstance();
-        if(!ctx.m_Events.template Has<Event>()) {
+        if(handle.m_Pool >= ctx.m_Events.size() || !ctx.m_Events[handle.m_Pool]) {
             return;
         }
 
-        auto& eventPool = ctx.m_Events.template Get<Event>();
-        const auto it = std::find_if(eventPool.cbegin(), eventPool.cend(), [callback](const auto& storage) noexcept {
-            return storage == callback;
-        });
+        auto& pool = *ctx.m_Events[handle.m_Pool];
+        if(handle.m_Slot >= pool.m_Slots.size() || pool.m_Slots[handle.m_Slot].m_Generation != handle.m_Generation) {
+            return;
+        }
+
+        RemoveListener(pool, pool.m_Slots[handle.m_Slot].m_Index);
+    }
+
+    template <typename Func, typename... Args>
+    requires std::invocable<Func, Args...>
+    [[nodiscard]] auto Engine::Submit(Func&& func, [[maybe_unused]] Args&&... args) {
+        return Engine::Context::GetInstance().m_Jobs.Submit(std::forward<Func>(func), std::forward<Args>(args)...);
+    }
+
+    template <typename Func>
+    requires std::invocable<Func&, std::size_t>
+    void Engine::ParallelFor(std::size_t begin, std::size_t end, Func&& func, std::size_t grain) {
+        Engine::Context::GetInstance().m_Jobs.ParallelFor(begin, end, std::forward<Func>(func), grain);
+    }
+
+    inline void Engine::WaitJobs() {
+        Engine::Context::GetInstance().m_Jobs.Wait();
+    }
+
+    template <typename T>
+    void Engine::WaitJobs(const std::future<T>& future) {
+        Engine::Context::GetInstance().m_Jobs.Wait(future);
+    }
+
+    inline void Engine::WakeupAt(std::uint64_t time) noexcept {
+        auto& ctx = Engine::Context::GetInstance();
+        ctx.m_TimeWakeup = (std::min)(ctx.m_TimeWakeup, time);
+    }
+
+    template <typename Rep, typename Period>
+    [[nodiscard]] Types::CoroutineScheduler::DelayAwaiter Engine::Delay(std::chrono::duration<Rep, Period> delay) {
+        return Engine::Context::GetInstance().m_Coroutines.Delay(delay);
+    }
+
+    [[nodiscard]] inline Types::CoroutineScheduler::DelayAwaiter Engine::Delay(std::uint64_t ms) {
+        return Engine::Context::GetInstance().m_Coroutines.Delay(ms);
+    }
+
+    [[nodiscard]] inline Types::CoroutineScheduler::NextAwaiter Engine::NextTick() {
+        return Engine::Context::GetInstance().m_Coroutines.NextTick();
+    }
+
+    [[nodiscard]] inline Types::CoroutineScheduler::NextAwaiter Engine::NextUpdate() {
+        return Engine::Context::GetInstance().m_Coroutines.NextUpdate();
+    }
+
+    template <typename Event>
+    [[nodiscard]] Engine::EventAwaiter<Event> Engine::WaitEvent()
+    {
+        static_assert(Traits::SameAS<Event, Traits::RemoveCVRP<Event>>, "Event type incorrect");
+        static_assert(std::is_empty_v<Event> || std::is_copy_constructible_v<Event>, "Event should be copy constructible");
+
+        return EventAwaiter<Event>{};
+    }
+
+    template <typename Event>
+    Engine::EventAwaiter<Event>::~EventAwaiter() {
+        Unsubscribe();
+    }
+
+    template <typename Event>
+    void Engine::EventAwaiter<Event>::await_suspend(Types::Coroutine::Handle handle)
+    {
+        auto& ctx = Engine::Context::GetInstance();
 
-        if(it != eventPool.cend()) {
-            eventPool.erase(it);
+        // The listener refers to the awaiter: it lives in the coroutine frame until the resume
+        auto listener = CallbackStorage{&OnEvent, &OnEvent};
+        listener.m_System = this;
+
+        const auto eventHandle = AddListener<Event>(ctx, listener);
+        m_Pool = ctx.m_Events[eventHandle.m_Pool].get();
+        m_Slot = eventHandle.m_Slot;
+        m_Generation = eventHandle.m_Generation;
+        m_Handle = handle;
+
+        ctx.m_Coroutines.Suspend(handle);
+    }
+
+    template <typename Event>
+    [[nodiscard]] Event Engine::EventAwaiter<Event>::await_resume()
+    {
+        if constexpr(std::is_empty_v<Event>) {
+            return Event{};
+        } else {
+            HELENA_ASSERT(m_Event, "Event is not signaled");
+            return std::move(*m_Event);
+        }
+    }
+
+    template <typename Event>
+    void Engine::EventAwaiter<Event>::OnEvent(CallbackStorage& listener, const void* data)
+    {
+        auto& awaiter = *static_cast<EventAwaiter*>(listener.m_System);
+        if constexpr(!std::is_empty_v<Event>) {
+            awaiter.m_Event.emplace(*static_cast<const Event*>(data));
         }
+
+        // Only the first event is taken, the next ones of the queued batch are skipped
+        awaiter.Unsubscribe();
+        Engine::Context::GetInstance().m_Coroutines.Schedule(awaiter.m_Handle);
+    }
+
+    template <typename Event>
+    void Engine::EventAwaiter<Event>::Unsubscribe() noexcept
+    {
+        // The listener is already removed if the listeners of the event were cleared
+        if(m_Pool && m_Pool->m_Slots[m_Slot].m_Generation == m_Generation) {
+            RemoveListener(*m_Pool, m_Pool->m_Slots[m_Slot].m_Index);
+        }
+
+        m_Pool = nullptr;
     }
 }
 
@@ -44,21 +44,33 @@
 #include <Helena/Types/BasicLoggersDef.hpp>
 #include <Helena/Types/BasicLogger.hpp>
 #include <Helena/Types/BenchmarkScoped.hpp>
+#include <Helena/Types/Clock.hpp>
+#include <Helena/Types/Coroutine.hpp>
 #include <Helena/Types/DateTime.hpp>
 #include <Helena/Types/Delegate.hpp>
 #include <Helena/Types/FixedBuffer.hpp>
+#include <Helena/Types/FlatIndex.hpp>
 #include <Helena/Types/Format.hpp>
+#include <Helena/Types/FrameProfiler.hpp>
 #include <Helena/Types/Hash.hpp>
+#include <Helena/Types/Histogram.hpp>
+#include <Helena/Types/InplaceFunction.hpp>
+#include <Helena/Types/JobSystem.hpp>
 #include <Helena/Types/LocationString.hpp>
 #include <Helena/Types/Monostate.hpp>
+#include <Helena/Types/MPSCQueue.hpp>
 #include <Helena/Types/Mutex.hpp>
+#include <Helena/Types/Reactor.hpp>
+#include <Helena/Types/ShardedTaskScheduler.hpp>
 #include <Helena/Types/SourceLocation.hpp>
 #include <Helena/Types/Spinlock.hpp>
+#include <Helena/Types/TaskQueue.hpp>
 #include <Helena/Types/TaskScheduler.hpp>
 #include <Helena/Types/TimeSpan.hpp>
 #include <Helena/Types/TSVector.hpp>
 #include <Helena/Types/UniqueIndexer.hpp>
 #include <Helena/Types/VectorAny.hpp>
+#include <Helena/Types/VectorArena.hpp>
 #include <Helena/Types/VectorKVAny.hpp>
 #include <Helena/Types/VectorUnique.hpp>
 
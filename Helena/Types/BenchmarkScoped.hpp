@@ -2,6 +2,7 @@
 #define HELENA_TYPES_BENCHMARKSCOPED_HPP
 
 #include <Helena/Engine/Log.hpp>
+#include <Helena/Types/Clock.hpp>
 
 #include <cstdint>
 #include <chrono>
@@ -10,8 +11,6 @@ namespace Helena::Types
 {
     class BenchmarkScoped
     {
-        using Timer = std::chrono::steady_clock;
-
         struct Benchmark {
             [[nodiscard]] static constexpr auto GetPrefix() noexcept {
                 return Log::CreatePrefix("[Benchmark:");
@@ -23,9 +22,9 @@ namespace Helena::Types
         };
 
     public:
-        BenchmarkScoped(const Types::SourceLocation& location = Types::SourceLocation::Create()) : m_Location{location}, m_Time{Timer::now()} {}
+        BenchmarkScoped(const Types::SourceLocation& location = Types::SourceLocation::Create()) : m_Location{location}, m_Time{Clock::Now()} {}
         ~BenchmarkScoped() {
-            const std::chrono::duration<float> timeleft = Timer::now() - m_Time;
+            const std::chrono::duration<float> timeleft = Clock::Duration{Clock::Now() - m_Time};
             const auto formater = Helena::Log::Formater<Benchmark>{"{}] Timeleft: {:.6f} sec", m_Location};
             Log::Console<Benchmark>(formater, m_Location.GetFunction(), timeleft.count());
         }
@@ -35,7 +34,7 @@ namespace Helena::Types
         BenchmarkScoped& operator=(BenchmarkScoped&&) noexcept = delete;
     private:
         Types::SourceLocation m_Location;
-        Timer::time_point m_Time;
+        std::uint64_t m_Time;
     };
 }
 
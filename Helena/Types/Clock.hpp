@@ -0,0 +1,170 @@
+#ifndef HELENA_TYPES_CLOCK_HPP
+#define HELENA_TYPES_CLOCK_HPP
+
+#include <Helena/Platform/Defines.hpp>
+#include <Helena/Platform/Platform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+
+#if defined(HELENA_PLATFORM_LINUX)
+    #include <time.h>
+#endif
+
+#if defined(HELENA_CLOCK_TSC) && (defined(HELENA_PROCESSOR_AMD64) || defined(HELENA_PROCESSOR_X86))
+    #if defined(HELENA_COMPILER_MSVC)
+        #include <intrin.h>
+    #else
+        #include <x86intrin.h>
+    #endif
+    #define HELENA_CLOCK_TSC_ENABLED
+#endif
+
+namespace Helena::Types
+{
+    /**
+    * @brief Monotonic clock with nanosecond resolution
+    * @note
+    * Linux: CLOCK_MONOTONIC, Windows: QueryPerformanceCounter
+    * The time is in the same domain as std::chrono::steady_clock
+    * Define HELENA_CLOCK_TSC to read the invariant TSC calibrated against the monotonic clock (x86 only),
+    * use it only on machines with a constant and synchronized TSC.
+    * The TSC time drifts from the monotonic clock by the calibration error (~100 ppm),
+    * ToSteady converts the time through the current offset between them for the OS waits.
+    */
+    class Clock final
+    {
+    #if defined(HELENA_CLOCK_TSC_ENABLED)
+        struct Calibration
+        {
+            Calibration() noexcept
+            {
+                // Measure the TSC frequency over ~10 ms of the monotonic clock
+                constexpr std::uint64_t period = 10'000'000;
+
+                const auto timeStart = Monotonic();
+                const auto tscStart = __rdtsc();
+
+                auto timeEnd = Monotonic();
+                while(timeEnd - timeStart < period) {
+                    HELENA_PROCESSOR_YIELD();
+                    timeEnd = Monotonic();
+                }
+
+                const auto tscEnd = __rdtsc();
+
+                m_NanoPerTick = static_cast<double>(timeEnd - timeStart) / static_cast<double>(tscEnd - tscStart);
+                m_TimeBase = timeEnd;
+                m_TSCBase = tscEnd;
+            }
+
+            double m_NanoPerTick;
+            std::uint64_t m_TimeBase;
+            std::uint64_t m_TSCBase;
+        };
+
+        [[nodiscard]] static const Calibration& GetCalibration() noexcept {
+            static const Calibration calibration{};
+            return calibration;
+        }
+    #endif
+
+    public:
+        using Duration = std::chrono::nanoseconds;
+
+        Clock() = delete;
+        Clock(const Clock&) = delete;
+        Clock(Clock&&) noexcept = delete;
+        Clock& operator=(const Clock&) = delete;
+        Clock& operator=(Clock&&) noexcept = delete;
+
+        /**
+        * @brief Returns the current time
+        * @return Time in nanoseconds
+        */
+        [[nodiscard]] static std::uint64_t Now() noexcept
+        {
+        #if defined(HELENA_CLOCK_TSC_ENABLED)
+            const auto& calibration = GetCalibration();
+            const auto ticks = static_cast<double>(__rdtsc() - calibration.m_TSCBase);
+            return calibration.m_TimeBase + static_cast<std::uint64_t>(ticks * calibration.m_NanoPerTick);
+        #else
+            return Monotonic();
+        #endif
+        }
+
+        /**
+        * @brief Calibrate the TSC fast path
+        * @note Takes ~10 ms, call it at startup to avoid the delay on the first Now()
+        * Does nothing without HELENA_CLOCK_TSC
+        */
+        static void Calibrate() noexcept {
+        #if defined(HELENA_CLOCK_TSC_ENABLED)
+            (void)GetCalibration();
+        #endif
+        }
+
+        /**
+        * @brief Returns the monotonic time of the OS, bypassing the TSC fast path
+        * @return Time in nanoseconds
+        */
+        [[nodiscard]] static std::uint64_t Monotonic() noexcept
+        {
+        #if defined(HELENA_PLATFORM_WIN)
+            static const auto frequency = []() noexcept {
+                LARGE_INTEGER value;
+                QueryPerformanceFrequency(&value);
+                return static_cast<std::uint64_t>(value.QuadPart);
+            }();
+
+            LARGE_INTEGER now;
+            QueryPerformanceCounter(&now);
+            const auto counter = static_cast<std::uint64_t>(now.QuadPart);
+            return counter / frequency * 1'000'000'000 + counter % frequency * 1'000'000'000 / frequency;
+        #elif defined(HELENA_PLATFORM_LINUX)
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC, &ts);
+            return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<std::uint64_t>(ts.tv_nsec);
+        #endif
+        }
+
+        /**
+        * @brief Returns the coarse monotonic time of the OS
+        * @return Time in nanoseconds
+        * @note
+        * Linux: CLOCK_MONOTONIC_COARSE, the time of the last timer interrupt (1-4 ms resolution),
+        * read without the counter access, never ahead of Monotonic().
+        * Other platforms: Monotonic()
+        */
+        [[nodiscard]] static std::uint64_t Coarse() noexcept
+        {
+        #if defined(HELENA_PLATFORM_LINUX) && defined(CLOCK_MONOTONIC_COARSE)
+            timespec ts;
+            clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+            return static_cast<std::uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<std::uint64_t>(ts.tv_nsec);
+        #else
+            return Monotonic();
+        #endif
+        }
+
+        /**
+        * @brief Convert the time of clock to std::chrono::steady_clock time point
+        * @param time Time in nanoseconds
+        * @return Time point
+        * @note With HELENA_CLOCK_TSC the time is converted by the distance from Now(), the drift is not accumulated
+        */
+        [[nodiscard]] static std::chrono::steady_clock::time_point ToSteady(std::uint64_t time) noexcept
+        {
+        #if defined(HELENA_CLOCK_TSC_ENABLED)
+            const auto now = Now();
+            const auto monotonic = Monotonic();
+            time = time >= now ? monotonic + (time - now) : monotonic - (std::min)(monotonic, now - time);
+        #endif
+
+            return std::chrono::steady_clock::time_point{std::chrono::duration_cast<std::chrono::steady_clock::duration>(Duration{time})};
+        }
+    };
+}
+
+#endif // HELENA_TYPES_CLOCK_HPP
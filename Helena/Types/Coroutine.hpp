@@ -0,0 +1,445 @@
+#ifndef HELENA_TYPES_COROUTINE_HPP
+#define HELENA_TYPES_COROUTINE_HPP
+
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Types/TaskScheduler.hpp>
+
+#include <array>
+#include <chrono>
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Pool of the coroutine frames
+    * @note
+    * Frames up to 1 KiB are rounded up to the size class of 64 bytes and reused from the free list of the class,
+    * the larger frames use the global operator new.
+    * The free lists are thread local: the frame is returned to the list of the thread that destroys it.
+    */
+    class CoroutineFramePool final
+    {
+        static constexpr std::size_t Granularity = 64;
+        static constexpr std::size_t Classes = 16;
+
+        struct Block {
+            Block* m_Next;
+        };
+
+        struct Lists {
+            Lists() = default;
+            ~Lists() {
+                for(std::size_t index = 0; index < Classes; ++index) {
+                    while(auto* block = m_Heads[index]) {
+                        m_Heads[index] = block->m_Next;
+                        ::operator delete(block, (index + 1) * Granularity);
+                    }
+                }
+            }
+            Lists(const Lists&) = delete;
+            Lists(Lists&&) noexcept = delete;
+            Lists& operator=(const Lists&) = delete;
+            Lists& operator=(Lists&&) noexcept = delete;
+
+            std::array<Block*, Classes> m_Heads {};
+        };
+
+        [[nodiscard]] static Lists& GetLists() noexcept {
+            thread_local Lists lists;
+            return lists;
+        }
+
+    public:
+        [[nodiscard]] static void* Allocate(std::size_t size)
+        {
+            const auto index = (size - 1) / Granularity;
+            if(index >= Classes) {
+                return ::operator new(size);
+            }
+
+            auto& head = GetLists().m_Heads[index];
+            if(auto* block = head) {
+                head = block->m_Next;
+                return block;
+            }
+
+            return ::operator new((index + 1) * Granularity);
+        }
+
+        static void Free(void* ptr, std::size_t size) noexcept
+        {
+            const auto index = (size - 1) / Granularity;
+            if(index >= Classes) {
+                ::operator delete(ptr, size);
+                return;
+            }
+
+            auto& head = GetLists().m_Heads[index];
+            head = new (ptr) Block{head};
+        }
+    };
+
+    class CoroutineScheduler;
+
+    /**
+    * @brief Detached coroutine task resumed by the CoroutineScheduler
+    * @note
+    * The coroutine starts immediately and runs until the first co_await,
+    * the frame is destroyed when the coroutine returns or by CoroutineScheduler::Clear.
+    * Frames are allocated from the CoroutineFramePool.
+    * The exception not handled by the coroutine is propagated to the caller or the resumer (Tick or Update),
+    * the frame of the coroutine is destroyed before.
+    * @code{.cpp}
+    * Types::Coroutine Respawn(Types::CoroutineScheduler& scheduler, Entity entity) {
+    *     co_await scheduler.Delay(std::chrono::seconds{5});
+    *     Spawn(entity);
+    *     co_await scheduler.NextTick();
+    *     Notify(entity);
+    * }
+    * @endcode
+    */
+    class Coroutine final
+    {
+    public:
+        class promise_type;
+
+        //! Destroys the frame of the coroutine completed before the first resume, otherwise the resumer destroys it
+        struct FinalAwaiter {
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(std::coroutine_handle<promise_type> handle) const noexcept;
+            void await_resume() const noexcept {}
+        };
+
+        class promise_type
+        {
+            friend class CoroutineScheduler;
+            friend struct FinalAwaiter;
+
+        public:
+            [[nodiscard]] static void* operator new(std::size_t size) {
+                return CoroutineFramePool::Allocate(size);
+            }
+
+            static void operator delete(void* ptr, std::size_t size) noexcept {
+                CoroutineFramePool::Free(ptr, size);
+            }
+
+            [[nodiscard]] Coroutine get_return_object() const noexcept {
+                return Coroutine{};
+            }
+
+            [[nodiscard]] std::suspend_never initial_suspend() const noexcept {
+                return {};
+            }
+
+            [[nodiscard]] FinalAwaiter final_suspend() const noexcept {
+                return {};
+            }
+
+            void return_void() const noexcept {}
+
+            void unhandled_exception()
+            {
+                // Before the first resume the exception is propagated to the caller
+                if(!m_Resumed) {
+                    throw;
+                }
+
+                m_Exception = std::current_exception();
+            }
+
+        private:
+            // Intrusive list of the suspended coroutines of the scheduler
+            promise_type* m_Prev {};
+            promise_type* m_Next {};
+            std::exception_ptr m_Exception;
+            bool m_Resumed {};
+        };
+
+        using Handle = std::coroutine_handle<promise_type>;
+
+    private:
+        Coroutine() noexcept = default;
+    };
+
+    inline void Coroutine::FinalAwaiter::await_suspend(std::coroutine_handle<promise_type> handle) const noexcept {
+        if(!handle.promise().m_Resumed) {
+            handle.destroy();
+        }
+    }
+
+    /**
+    * @brief Resumes the coroutines suspended by the awaiters of the scheduler
+    * @note
+    * Delay: resumed by the first Tick after the delay, the timers are kept in the timing wheel (1 ms resolution).
+    * NextTick: resumed by the next Tick.
+    * NextUpdate: resumed by the next Update.
+    * A coroutine suspended again while it is resumed by Tick or Update waits for the next call.
+    * The exception of the resumed coroutine is rethrown by Tick or Update,
+    * the coroutines not resumed yet by this call are resumed by the next one.
+    * Custom awaiters call Suspend in await_suspend and Schedule when the coroutine is ready to resume.
+    * @code{.cpp}
+    * Types::CoroutineScheduler scheduler;
+    * Patrol(scheduler, entity);
+    * for(;;) {
+    *     scheduler.Tick();
+    *     scheduler.Update();
+    * }
+    * @endcode
+    */
+    class CoroutineScheduler final
+    {
+        using Handle = Coroutine::Handle;
+        using Timers = TaskSchedulerWheel;
+
+    public:
+        //! Resumes the coroutine by the Tick after the delay
+        class DelayAwaiter
+        {
+            friend class CoroutineScheduler;
+
+            DelayAwaiter(CoroutineScheduler& scheduler, std::chrono::nanoseconds delay) noexcept
+                : m_Scheduler{scheduler}, m_Delay{delay} {}
+
+        public:
+            ~DelayAwaiter() = default;
+            DelayAwaiter(const DelayAwaiter&) = delete;
+            DelayAwaiter(DelayAwaiter&&) noexcept = delete;
+            DelayAwaiter& operator=(const DelayAwaiter&) = delete;
+            DelayAwaiter& operator=(DelayAwaiter&&) noexcept = delete;
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(Handle handle)
+            {
+                auto& scheduler = m_Scheduler;
+                scheduler.m_Timers.Create(scheduler.m_TimerId++, m_Delay, [&scheduler, handle](std::uint64_t, std::uint64_t&, std::uint32_t&) {
+                    scheduler.m_Ready.push_back(handle);
+                });
+
+                scheduler.Suspend(handle);
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            CoroutineScheduler& m_Scheduler;
+            std::chrono::nanoseconds m_Delay;
+        };
+
+        //! Resumes the coroutine by the next Tick or Update
+        class NextAwaiter
+        {
+            friend class CoroutineScheduler;
+
+            NextAwaiter(CoroutineScheduler& scheduler, std::vector<Handle>& list) noexcept
+                : m_Scheduler{scheduler}, m_List{list} {}
+
+        public:
+            ~NextAwaiter() = default;
+            NextAwaiter(const NextAwaiter&) = delete;
+            NextAwaiter(NextAwaiter&&) noexcept = delete;
+            NextAwaiter& operator=(const NextAwaiter&) = delete;
+            NextAwaiter& operator=(NextAwaiter&&) noexcept = delete;
+
+            [[nodiscard]] bool await_ready() const noexcept {
+                return false;
+            }
+
+            void await_suspend(Handle handle) {
+                m_List.push_back(handle);
+                m_Scheduler.Suspend(handle);
+            }
+
+            void await_resume() const noexcept {}
+
+        private:
+            CoroutineScheduler& m_Scheduler;
+            std::vector<Handle>& m_List;
+        };
+
+    public:
+        CoroutineScheduler() = default;
+        ~CoroutineScheduler() {
+            Clear();
+        }
+        CoroutineScheduler(const CoroutineScheduler&) = delete;
+        CoroutineScheduler(CoroutineScheduler&&) noexcept = delete;
+        CoroutineScheduler& operator=(const CoroutineScheduler&) = delete;
+        CoroutineScheduler& operator=(CoroutineScheduler&&) noexcept = delete;
+
+        template <typename Rep, typename Period>
+        [[nodiscard]] DelayAwaiter Delay(std::chrono::duration<Rep, Period> delay) noexcept {
+            return DelayAwaiter{*this, std::chrono::ceil<std::chrono::nanoseconds>(delay)};
+        }
+
+        [[nodiscard]] DelayAwaiter Delay(std::uint64_t ms) noexcept {
+            return Delay(std::chrono::milliseconds{ms});
+        }
+
+        [[nodiscard]] NextAwaiter NextTick() noexcept {
+            return NextAwaiter{*this, m_Ticks};
+        }
+
+        [[nodiscard]] NextAwaiter NextUpdate() noexcept {
+            return NextAwaiter{*this, m_Updates};
+        }
+
+        /**
+        * @brief Register the suspended coroutine
+        * @param handle Coroutine suspended by the awaiter
+        * @note The coroutine is destroyed by Clear if it is not resumed
+        */
+        void Suspend(Handle handle) noexcept
+        {
+            auto& promise = handle.promise();
+            HELENA_ASSERT(!promise.m_Prev && m_Head != &promise, "Coroutine already suspended");
+
+            promise.m_Next = m_Head;
+            if(m_Head) {
+                m_Head->m_Prev = &promise;
+            }
+
+            m_Head = &promise;
+        }
+
+        /**
+        * @brief Resume the suspended coroutine by the next Tick
+        * @param handle Coroutine registered by Suspend
+        */
+        void Schedule(Handle handle) {
+            m_Ready.push_back(handle);
+        }
+
+        /**
+        * @brief Resume the coroutines of the expired delays, the scheduled and the NextTick awaiters
+        */
+        void Tick() {
+            Tick(TaskClockPrecise::Now());
+        }
+
+        /**
+        * @brief Resume the coroutines of the delays expired at the time, the scheduled and the NextTick awaiters
+        * @param timeNow Time in nanoseconds of Types::Clock
+        */
+        void Tick(std::uint64_t timeNow)
+        {
+            m_Timers.Update(timeNow);
+
+            HELENA_ASSERT(m_Resuming.empty(), "Nested resume");
+            m_Resuming.swap(m_Ready);
+            m_Resuming.insert(m_Resuming.end(), m_Ticks.begin(), m_Ticks.end());
+            m_Ticks.clear();
+            ResumePending(m_Ready);
+        }
+
+        /**
+        * @brief Resume the coroutines of the NextUpdate awaiters
+        */
+        void Update()
+        {
+            HELENA_ASSERT(m_Resuming.empty(), "Nested resume");
+            m_Resuming.swap(m_Updates);
+            ResumePending(m_Updates);
+        }
+
+        /**
+        * @brief Destroy the suspended coroutines
+        * @note The local objects of the coroutines are destroyed, the coroutines are not resumed
+        */
+        void Clear()
+        {
+            m_Timers.Clear();
+            m_Ready.clear();
+            m_Ticks.clear();
+            m_Updates.clear();
+            m_Resuming.clear();
+
+            while(auto* promise = m_Head) {
+                Unlink(*promise);
+                Handle::from_promise(*promise).destroy();
+            }
+        }
+
+        /**
+        * @brief Returns the time of the earliest delay
+        * @return Time in nanoseconds of Types::Clock or max if there are no delays
+        * @note Can be passed to Engine::WakeupAt
+        */
+        [[nodiscard]] std::uint64_t NextTime() const noexcept {
+            return m_Timers.NextTime();
+        }
+
+        [[nodiscard]] bool Empty() const noexcept {
+            return !m_Head;
+        }
+
+    private:
+        void Unlink(Coroutine::promise_type& promise) noexcept
+        {
+            if(promise.m_Prev) {
+                promise.m_Prev->m_Next = promise.m_Next;
+            } else {
+                m_Head = promise.m_Next;
+            }
+
+            if(promise.m_Next) {
+                promise.m_Next->m_Prev = promise.m_Prev;
+            }
+
+            promise.m_Prev = nullptr;
+            promise.m_Next = nullptr;
+        }
+
+        void ResumePending(std::vector<Handle>& next)
+        {
+            // Clear called by the coroutine empties the list
+            for(std::size_t index = 0; index < m_Resuming.size(); ++index)
+            {
+                const auto handle = m_Resuming[index];
+                auto& promise = handle.promise();
+                Unlink(promise);
+                promise.m_Resumed = true;
+                handle.resume();
+
+                if(!handle.done()) {
+                    continue;
+                }
+
+                const auto exception = std::move(promise.m_Exception);
+                handle.destroy();
+
+                if(exception) {
+                    // The rest of the list is resumed by the next call
+                    next.insert(next.begin(), m_Resuming.begin() + index + 1, m_Resuming.end());
+                    m_Resuming.clear();
+                    std::rethrow_exception(exception);
+                }
+            }
+
+            m_Resuming.clear();
+        }
+
+    private:
+        Timers m_Timers;
+        std::vector<Handle> m_Ready;
+        std::vector<Handle> m_Ticks;
+        std::vector<Handle> m_Updates;
+        std::vector<Handle> m_Resuming;
+        Coroutine::promise_type* m_Head {};
+        std::uint64_t m_TimerId {};
+    };
+}
+
+#endif // HELENA_TYPES_COROUTINE_HPP
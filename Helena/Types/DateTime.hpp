@@ -3,6 +3,7 @@
 
 #include <Helena/Platform/Assert.hpp>
 #include <Helena/Platform/Platform.hpp>
+#include <Helena/Types/Clock.hpp>
 #include <array>
 #include <cmath>
 #include <ctime>
@@ -61,7 +62,7 @@ namespace Helena::Types
         constexpr DateTime& operator=(DateTime&&) noexcept = default;
 
         [[nodiscard]] static DateTime FromTickTime() {
-            return FromSeconds(std::chrono::duration_cast<std::chrono::seconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+            return FromSeconds(std::chrono::duration_cast<std::chrono::seconds>(Clock::Duration{Clock::Now()}).count());
         }
 
         [[nodiscard]] static DateTime FromUTCTime() {
@@ -0,0 +1,240 @@
+#ifndef HELENA_TYPES_FLATINDEX_HPP
+#define HELENA_TYPES_FLATINDEX_HPP
+
+#include <Helena/Platform/Assert.hpp>
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Open addressing hash index of 64-bit keys to 32-bit values (e.g. id to slot)
+    * @note
+    * Linear probing in the flat array of {key, value} with the Fibonacci hashing of the key,
+    * erase shifts the following entries back (no tombstones).
+    * The array grows by 2 when the load factor exceeds 3/4, otherwise Insert and Erase don't allocate.
+    */
+    class FlatIndex final
+    {
+        struct Entry {
+            std::uint64_t m_Key;
+            std::uint32_t m_Value;
+        };
+
+        static constexpr std::size_t MinCapacity = 16;
+
+    public:
+        static constexpr auto None = (std::numeric_limits<std::uint32_t>::max)();
+
+    public:
+        FlatIndex() : m_Entries{}, m_Size{}, m_Shift{64} {}
+        ~FlatIndex() = default;
+        FlatIndex(const FlatIndex&) = default;
+        FlatIndex(FlatIndex&&) noexcept = default;
+        FlatIndex& operator=(const FlatIndex&) = default;
+        FlatIndex& operator=(FlatIndex&&) noexcept = default;
+
+        /**
+        * @brief Returns the value of the key
+        * @param key Key
+        * @return Value or None if the key not found
+        */
+        [[nodiscard]] std::uint32_t Find(std::uint64_t key) const noexcept
+        {
+            if(m_Entries.empty()) {
+                return None;
+            }
+
+            const auto mask = m_Entries.size() - 1;
+            for(auto pos = Home(key);; pos = (pos + 1) & mask)
+            {
+                const auto& entry = m_Entries[pos];
+                if(entry.m_Value == None) {
+                    return None;
+                }
+
+                if(entry.m_Key == key) {
+                    return entry.m_Value;
+                }
+            }
+        }
+
+        [[nodiscard]] bool Contains(std::uint64_t key) const noexcept {
+            return Find(key) != None;
+        }
+
+        /**
+        * @brief Insert the key
+        * @param key Key
+        * @param value Value, should not be None
+        * @return False if the key already exists
+        */
+        bool Insert(std::uint64_t key, std::uint32_t value)
+        {
+            HELENA_ASSERT(value != None, "Value is reserved");
+
+            if((m_Size + 1) * 4 > m_Entries.size() * 3) {
+                Rehash((std::max)(MinCapacity, m_Entries.size() * 2));
+            }
+
+            const auto mask = m_Entries.size() - 1;
+            for(auto pos = Home(key);; pos = (pos + 1) & mask)
+            {
+                auto& entry = m_Entries[pos];
+                if(entry.m_Value == None) {
+                    entry = Entry{key, value};
+                    ++m_Size;
+                    return true;
+                }
+
+                if(entry.m_Key == key) {
+                    return false;
+                }
+            }
+        }
+
+        /**
+        * @brief Set the value of the existing key
+        * @param key Key
+        * @param value Value, should not be None
+        * @return False if the key not found
+        */
+        bool Assign(std::uint64_t key, std::uint32_t value) noexcept
+        {
+            HELENA_ASSERT(value != None, "Value is reserved");
+
+            if(m_Entries.empty()) {
+                return false;
+            }
+
+            const auto mask = m_Entries.size() - 1;
+            for(auto pos = Home(key);; pos = (pos + 1) & mask)
+            {
+                auto& entry = m_Entries[pos];
+                if(entry.m_Value == None) {
+                    return false;
+                }
+
+                if(entry.m_Key == key) {
+                    entry.m_Value = value;
+                    return true;
+                }
+            }
+        }
+
+        /**
+        * @brief Erase the key
+        * @param key Key
+        * @return False if the key not found
+        */
+        bool Erase(std::uint64_t key) noexcept
+        {
+            if(m_Entries.empty()) {
+                return false;
+            }
+
+            const auto mask = m_Entries.size() - 1;
+            auto pos = Home(key);
+            for(;; pos = (pos + 1) & mask)
+            {
+                const auto& entry = m_Entries[pos];
+                if(entry.m_Value == None) {
+                    return false;
+                }
+
+                if(entry.m_Key == key) {
+                    break;
+                }
+            }
+
+            // Shift back the entries of the probe sequence that can't be found after the hole
+            for(auto next = (pos + 1) & mask;; next = (next + 1) & mask)
+            {
+                const auto& entry = m_Entries[next];
+                if(entry.m_Value == None) {
+                    break;
+                }
+
+                // The entry stays if its home is cyclically in (pos, next]
+                const auto home = Home(entry.m_Key);
+                if(((next - home) & mask) >= ((next - pos) & mask)) {
+                    m_Entries[pos] = entry;
+                    pos = next;
+                }
+            }
+
+            m_Entries[pos].m_Value = None;
+            --m_Size;
+            return true;
+        }
+
+        /**
+        * @brief Reserve the capacity for the keys
+        * @param size Number of keys
+        */
+        void Reserve(std::size_t size)
+        {
+            const auto capacity = std::bit_ceil((std::max)(MinCapacity, (size * 4 + 2) / 3));
+            if(capacity > m_Entries.size()) {
+                Rehash(capacity);
+            }
+        }
+
+        void Clear() noexcept
+        {
+            for(auto& entry : m_Entries) {
+                entry.m_Value = None;
+            }
+
+            m_Size = 0;
+        }
+
+        [[nodiscard]] std::size_t Size() const noexcept {
+            return m_Size;
+        }
+
+        [[nodiscard]] bool Empty() const noexcept {
+            return !m_Size;
+        }
+
+    private:
+        [[nodiscard]] std::size_t Home(std::uint64_t key) const noexcept {
+            // Fibonacci hashing: the high bits of the product depend on all bits of the key
+            return static_cast<std::size_t>((key * 0x9E3779B97F4A7C15ull) >> m_Shift);
+        }
+
+        void Rehash(std::size_t capacity)
+        {
+            auto entries = std::move(m_Entries);
+            m_Entries.assign(capacity, Entry{0, None});
+            m_Shift = 64 - static_cast<std::uint32_t>(std::countr_zero(capacity));
+
+            const auto mask = capacity - 1;
+            for(const auto& entry : entries)
+            {
+                if(entry.m_Value == None) {
+                    continue;
+                }
+
+                auto pos = Home(entry.m_Key);
+                while(m_Entries[pos].m_Value != None) {
+                    pos = (pos + 1) & mask;
+                }
+
+                m_Entries[pos] = entry;
+            }
+        }
+
+    private:
+        std::vector<Entry> m_Entries;
+        std::size_t m_Size;
+        std::uint32_t m_Shift;
+    };
+}
+
+#endif // HELENA_TYPES_FLATINDEX_HPP
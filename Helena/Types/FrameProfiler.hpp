@@ -0,0 +1,190 @@
+#ifndef HELENA_TYPES_FRAMEPROFILER_HPP
+#define HELENA_TYPES_FRAMEPROFILER_HPP
+
+#include <Helena/Dependencies/Fmt.hpp>
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Types/Histogram.hpp>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string_view>
+#include <vector>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Ring of the recent frames with the timings of their phases
+    * @tparam Frames Number of frames in the ring
+    * @tparam Phases Maximum number of phases per frame, the rest are counted as dropped
+    * @note
+    * Time is in nanoseconds of Types::Clock, phase names should be string literals (stored as std::string_view).
+    * The ring is allocated on the first frame, the frame times are also collected in the histogram.
+    */
+    template <std::size_t Frames = 256, std::size_t Phases = 16>
+    class FrameProfiler
+    {
+        static_assert(Frames > 0 && Phases > 0, "FrameProfiler is empty");
+
+    public:
+        struct Phase {
+            std::string_view m_Name;
+            std::uint64_t m_Start;
+            std::uint64_t m_End;
+        };
+
+        struct Frame {
+            std::uint64_t m_Start;
+            std::uint64_t m_End;
+            std::uint32_t m_Count;      // Number of recorded phases
+            std::uint32_t m_Dropped;    // Number of phases over the Phases limit
+            std::array<Phase, Phases> m_Phases;
+        };
+
+    public:
+        FrameProfiler() : m_Frames{}, m_FrameTime{}, m_Head{}, m_Size{}, m_Open{} {}
+        ~FrameProfiler() = default;
+        FrameProfiler(const FrameProfiler&) = delete;
+        FrameProfiler(FrameProfiler&&) noexcept = delete;
+        FrameProfiler& operator=(const FrameProfiler&) = delete;
+        FrameProfiler& operator=(FrameProfiler&&) noexcept = delete;
+
+        /**
+        * @brief Start the frame, overwrites the oldest frame if the ring is full
+        * @param time Start time of the frame
+        */
+        void Begin(std::uint64_t time)
+        {
+            if(m_Frames.empty()) {
+                m_Frames.resize(Frames);
+            }
+
+            auto& frame = m_Frames[m_Head];
+            frame.m_Start = time;
+            frame.m_End = time;
+            frame.m_Count = 0;
+            frame.m_Dropped = 0;
+            m_Open = true;
+        }
+
+        /**
+        * @brief Record the phase of the current frame
+        * @param name Name of the phase
+        * @param start Start time of the phase
+        * @param end End time of the phase
+        */
+        void Record(std::string_view name, std::uint64_t start, std::uint64_t end) noexcept
+        {
+            if(!m_Open) {
+                return;
+            }
+
+            auto& frame = m_Frames[m_Head];
+            if(frame.m_Count == Phases) {
+                ++frame.m_Dropped;
+                return;
+            }
+
+            frame.m_Phases[frame.m_Count++] = Phase{name, start, end};
+        }
+
+        /**
+        * @brief Complete the current frame
+        * @param time End time of the frame
+        */
+        void End(std::uint64_t time) noexcept
+        {
+            if(!m_Open) {
+                return;
+            }
+
+            auto& frame = m_Frames[m_Head];
+            frame.m_End = time;
+            m_FrameTime.Record(time - frame.m_Start);
+
+            m_Head = (m_Head + 1) % Frames;
+            m_Size += m_Size < Frames;
+            m_Open = false;
+        }
+
+        void Reset() noexcept {
+            m_FrameTime.Reset();
+            m_Head = 0;
+            m_Size = 0;
+            m_Open = false;
+        }
+
+        /**
+        * @brief Returns the number of completed frames in the ring
+        */
+        [[nodiscard]] std::size_t Size() const noexcept {
+            return m_Size;
+        }
+
+        /**
+        * @brief Returns the completed frame
+        * @param index Index of the frame, 0 is the oldest one
+        */
+        [[nodiscard]] const Frame& Get(std::size_t index) const noexcept {
+            HELENA_ASSERT(index < m_Size, "Index out of range");
+            return m_Frames[(m_Head + Frames - m_Size + index) % Frames];
+        }
+
+        /**
+        * @brief Returns the histogram of the frame times of all completed frames
+        */
+        [[nodiscard]] const Histogram<>& GetFrameTime() const noexcept {
+            return m_FrameTime;
+        }
+
+        /**
+        * @brief Export the frames in the ring as Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+        * @param path Path of the file
+        * @return False if the file can't be written
+        */
+        [[nodiscard]] bool ExportChromeTrace(const std::filesystem::path& path) const
+        {
+            fmt::memory_buffer buffer;
+            auto out = std::back_inserter(buffer);
+
+            auto fnEvent = [&out, first = true](std::string_view name, std::uint64_t start, std::uint64_t end) mutable {
+                // Trace Event Format: complete events ("ph": "X") in microseconds
+                fmt::format_to(out, "{}\n{{\"name\":\"{}\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":{:.3f},\"dur\":{:.3f}}}",
+                    first ? "" : ",", name, start / 1'000.0, (end - start) / 1'000.0);
+                first = false;
+            };
+
+            fmt::format_to(out, "{{\"displayTimeUnit\":\"ns\",\"traceEvents\":[");
+            for(std::size_t index = 0; index < m_Size; ++index)
+            {
+                const auto& frame = Get(index);
+                fnEvent("Frame", frame.m_Start, frame.m_End);
+
+                for(std::uint32_t phase = 0; phase < frame.m_Count; ++phase) {
+                    fnEvent(frame.m_Phases[phase].m_Name, frame.m_Phases[phase].m_Start, frame.m_Phases[phase].m_End);
+                }
+            }
+            fmt::format_to(out, "\n]}}\n");
+
+            std::ofstream file{path, std::ios::binary | std::ios::trunc};
+            if(!file) {
+                return false;
+            }
+
+            file.write(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+            return static_cast<bool>(file);
+        }
+
+    private:
+        std::vector<Frame> m_Frames;
+        Histogram<> m_FrameTime;
+        std::size_t m_Head;
+        std::size_t m_Size;
+        bool m_Open;
+    };
+}
+
+#endif // HELENA_TYPES_FRAMEPROFILER_HPP
@@ -0,0 +1,118 @@
+#ifndef HELENA_TYPES_HISTOGRAM_HPP
+#define HELENA_TYPES_HISTOGRAM_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Log-linear histogram of unsigned values (e.g. time in nanoseconds)
+    * @tparam SubBits Number of bits of the linear sub-buckets in each power of 2
+    * @note
+    * Values below 2^(SubBits + 1) are exact, the relative error of the other values is 2^-SubBits.
+    * Record is O(1) without allocations, the storage is fixed: (65 - SubBits) * 2^SubBits counters.
+    */
+    template <std::size_t SubBits = 4>
+    class Histogram
+    {
+        static_assert(SubBits > 0 && SubBits < 16, "SubBits out of range");
+
+        static constexpr std::size_t SubBuckets = std::size_t{1} << SubBits;
+        static constexpr std::size_t Buckets = (65 - SubBits) * SubBuckets;
+
+        [[nodiscard]] static constexpr std::size_t Index(std::uint64_t value) noexcept
+        {
+            if(value < SubBuckets) {
+                return static_cast<std::size_t>(value);
+            }
+
+            const auto shift = static_cast<std::size_t>(std::bit_width(value)) - 1 - SubBits;
+            return shift * SubBuckets + static_cast<std::size_t>(value >> shift);
+        }
+
+        [[nodiscard]] static constexpr std::uint64_t UpperBound(std::size_t index) noexcept
+        {
+            if(index < SubBuckets * 2) {
+                return index;
+            }
+
+            const auto shift = index / SubBuckets - 1;
+            const auto mantissa = static_cast<std::uint64_t>(index % SubBuckets + SubBuckets);
+            return (mantissa << shift) + ((std::uint64_t{1} << shift) - 1);
+        }
+
+    public:
+        Histogram() noexcept : m_Buckets{}, m_Count{}, m_Total{}, m_Max{} {}
+        ~Histogram() = default;
+        Histogram(const Histogram&) = default;
+        Histogram(Histogram&&) noexcept = default;
+        Histogram& operator=(const Histogram&) = default;
+        Histogram& operator=(Histogram&&) noexcept = default;
+
+        void Record(std::uint64_t value) noexcept {
+            ++m_Buckets[Index(value)];
+            ++m_Count;
+            m_Total += value;
+            m_Max = (std::max)(m_Max, value);
+        }
+
+        void Reset() noexcept {
+            *this = Histogram{};
+        }
+
+        [[nodiscard]] std::uint64_t Count() const noexcept {
+            return m_Count;
+        }
+
+        [[nodiscard]] std::uint64_t Total() const noexcept {
+            return m_Total;
+        }
+
+        [[nodiscard]] std::uint64_t Max() const noexcept {
+            return m_Max;
+        }
+
+        [[nodiscard]] std::uint64_t Mean() const noexcept {
+            return m_Count ? m_Total / m_Count : 0;
+        }
+
+        /**
+        * @brief Returns the value at the percentile
+        * @param percentile Percentile in range [0, 100]
+        * @return Upper bound of the bucket that contains the percentile, but not greater than Max
+        */
+        [[nodiscard]] std::uint64_t Percentile(double percentile) const noexcept
+        {
+            if(!m_Count) {
+                return 0;
+            }
+
+            const auto rank = (std::max)(std::uint64_t{1},
+                static_cast<std::uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * static_cast<double>(m_Count))));
+
+            std::uint64_t count{};
+            for(std::size_t index = 0; index < Buckets; ++index)
+            {
+                count += m_Buckets[index];
+                if(count >= rank) {
+                    return (std::min)(UpperBound(index), m_Max);
+                }
+            }
+
+            return m_Max;
+        }
+
+    private:
+        std::array<std::uint64_t, Buckets> m_Buckets;
+        std::uint64_t m_Count;
+        std::uint64_t m_Total;
+        std::uint64_t m_Max;
+    };
+}
+
+#endif // HELENA_TYPES_HISTOGRAM_HPP
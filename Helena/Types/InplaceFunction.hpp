@@ -0,0 +1,202 @@
+#ifndef HELENA_TYPES_INPLACEFUNCTION_HPP
+#define HELENA_TYPES_INPLACEFUNCTION_HPP
+
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Traits/Remove.hpp>
+#include <Helena/Traits/Specialization.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Helena::Types
+{
+    template <typename Signature, std::size_t Capacity = sizeof(void*) * 6, std::size_t Align = alignof(std::max_align_t)>
+    class InplaceFunction;
+
+    /**
+    * @brief Move-only type-erased callable stored in the small buffer
+    * @tparam Ret Return type
+    * @tparam Args Types of arguments
+    * @tparam Capacity Size of the small buffer in bytes
+    * @tparam Align Alignment of the small buffer
+    * @note
+    * Callables that fit into the buffer and are nothrow movable are stored inplace and never touch the heap,
+    * the others are allocated (use IsInplace to check it at compile time).
+    * Unlike std::function the move-only callables are supported: captured unique_ptr, sockets, etc.
+    * @code{.cpp}
+    * Types::InplaceFunction<void (int), 32> fn = [buffer = std::make_unique<int>(1)](int value) {
+    *     *buffer += value;
+    * };
+    * fn(5);
+    * @endcode
+    */
+    template <typename Ret, typename... Args, std::size_t Capacity, std::size_t Align>
+    class InplaceFunction<Ret (Args...), Capacity, Align> final
+    {
+        static_assert(Capacity >= sizeof(void*), "Capacity is too small");
+
+        enum class EOperation : std::uint8_t {
+            Move,
+            Destroy
+        };
+
+        using Invoke = Ret (*)(void*, Args&&...);
+        using Manage = void (*)(EOperation, void*, void*) noexcept;
+
+        template <typename T>
+        [[nodiscard]] static T* Instance(void* storage) noexcept
+        {
+            if constexpr(IsInplace<T>) {
+                return std::launder(static_cast<T*>(storage));
+            } else {
+                return *static_cast<T**>(storage);
+            }
+        }
+
+        template <typename T>
+        static Ret InvokeObject(void* storage, Args&&... args) {
+            return std::invoke(*Instance<T>(storage), std::forward<Args>(args)...);
+        }
+
+        template <typename T>
+        static void ManageObject(EOperation operation, void* from, void* to) noexcept
+        {
+            switch(operation)
+            {
+                case EOperation::Move: {
+                    if constexpr(IsInplace<T>) {
+                        new (to) T(std::move(*Instance<T>(from)));
+                        std::destroy_at(Instance<T>(from));
+                    } else {
+                        new (to) T*(*static_cast<T**>(from));
+                    }
+                } break;
+                case EOperation::Destroy: {
+                    if constexpr(IsInplace<T>) {
+                        std::destroy_at(Instance<T>(from));
+                    } else {
+                        delete Instance<T>(from);
+                    }
+                } break;
+            }
+        }
+
+    public:
+        //! The callable is stored in the small buffer without allocation
+        template <typename T>
+        static constexpr bool IsInplace = sizeof(T) <= Capacity && Align % alignof(T) == 0
+            && std::is_nothrow_move_constructible_v<T>;
+
+    public:
+        InplaceFunction() noexcept : m_Invoke{}, m_Manage{} {}
+        InplaceFunction(std::nullptr_t) noexcept : InplaceFunction() {}
+
+        template <typename Func>
+        requires (!std::is_same_v<Traits::RemoveCVR<Func>, InplaceFunction>
+            && std::is_invocable_r_v<Ret, std::decay_t<Func>&, Args...>)
+        InplaceFunction(Func&& func) : InplaceFunction() {
+            Create(std::forward<Func>(func));
+        }
+
+        ~InplaceFunction() {
+            Reset();
+        }
+
+        InplaceFunction(const InplaceFunction&) = delete;
+        InplaceFunction(InplaceFunction&& other) noexcept : InplaceFunction() {
+            MoveFrom(other);
+        }
+
+        InplaceFunction& operator=(const InplaceFunction&) = delete;
+        InplaceFunction& operator=(InplaceFunction&& other) noexcept
+        {
+            if(this != &other) {
+                Reset();
+                MoveFrom(other);
+            }
+
+            return *this;
+        }
+
+        InplaceFunction& operator=(std::nullptr_t) noexcept {
+            Reset();
+            return *this;
+        }
+
+        template <typename Func>
+        requires (!std::is_same_v<Traits::RemoveCVR<Func>, InplaceFunction>
+            && std::is_invocable_r_v<Ret, std::decay_t<Func>&, Args...>)
+        InplaceFunction& operator=(Func&& func)
+        {
+            Reset();
+            Create(std::forward<Func>(func));
+            return *this;
+        }
+
+        Ret operator()(Args... args) {
+            HELENA_ASSERT(m_Invoke, "Function is empty");
+            return m_Invoke(m_Storage, std::forward<Args>(args)...);
+        }
+
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return m_Invoke;
+        }
+
+        [[nodiscard]] bool operator==(std::nullptr_t) const noexcept {
+            return !m_Invoke;
+        }
+
+    private:
+        template <typename Func>
+        void Create(Func&& func)
+        {
+            using T = std::decay_t<Func>;
+
+            // Empty function pointers and std::function produce the empty object
+            if constexpr(std::is_pointer_v<T> || std::is_member_pointer_v<T> || Traits::Specialization<T, std::function>) {
+                if(!func) {
+                    return;
+                }
+            }
+
+            if constexpr(IsInplace<T>) {
+                new (m_Storage) T(std::forward<Func>(func));
+            } else {
+                new (m_Storage) T*(new T(std::forward<Func>(func)));
+            }
+
+            m_Invoke = &InvokeObject<T>;
+            m_Manage = &ManageObject<T>;
+        }
+
+        void MoveFrom(InplaceFunction& other) noexcept
+        {
+            if(other.m_Manage) {
+                other.m_Manage(EOperation::Move, other.m_Storage, m_Storage);
+                m_Invoke = std::exchange(other.m_Invoke, nullptr);
+                m_Manage = std::exchange(other.m_Manage, nullptr);
+            }
+        }
+
+        void Reset() noexcept
+        {
+            if(m_Manage) {
+                const auto manage = std::exchange(m_Manage, nullptr);
+                m_Invoke = nullptr;
+                manage(EOperation::Destroy, m_Storage, nullptr);
+            }
+        }
+
+    private:
+        alignas(Align) std::byte m_Storage[Capacity];
+        Invoke m_Invoke;
+        Manage m_Manage;
+    };
+}
+
+#endif // HELENA_TYPES_INPLACEFUNCTION_HPP
@@ -0,0 +1,360 @@
+#ifndef HELENA_TYPES_JOBSYSTEM_HPP
+#define HELENA_TYPES_JOBSYSTEM_HPP
+
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Traits/Cacheline.hpp>
+#include <Helena/Types/Spinlock.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <future>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Work-stealing thread pool
+    * @note
+    * Every worker owns a deque: the owner pushes and pops from the back (LIFO),
+    * idle workers steal from the front (FIFO) of the other deques.
+    * Queue with index 0 belongs to the external threads (usually the engine thread),
+    * the external threads help to execute jobs while they are waiting (Wait, ParallelFor).
+    */
+    class JobSystem final
+    {
+        using Job = std::function<void ()>;
+
+        struct alignas(Traits::Cacheline) Queue {
+            std::deque<Job> m_Jobs {};
+            Spinlock m_Lock {};
+        };
+
+        //! Jobs of the pool running on the thread: nested by the waits that execute other jobs
+        struct ThreadJobs {
+            const JobSystem* m_Owner;
+            std::size_t m_Depth;    // Running jobs
+            std::size_t m_Blocked;  // Running jobs counted in m_Blocked of the pool
+        };
+
+    public:
+        JobSystem() : m_Queues{}, m_Threads{}, m_Pending{}, m_Blocked{}, m_Signal{}, m_Running{} {
+            m_Queues.emplace_back(std::make_unique<Queue>());
+        }
+        ~JobSystem() {
+            Stop();
+        }
+        JobSystem(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) noexcept = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem& operator=(JobSystem&&) noexcept = delete;
+
+        /**
+        * @brief Start the worker threads
+        * @param workers Number of worker threads
+        * @note With zero workers the jobs are executed by the threads that wait for them
+        */
+        void Start(std::size_t workers)
+        {
+            HELENA_ASSERT(!m_Running, "JobSystem already started!");
+            if(m_Running) {
+                return;
+            }
+
+            m_Running.store(true, std::memory_order_relaxed);
+            for(std::size_t index = 0; index < workers; ++index) {
+                m_Queues.emplace_back(std::make_unique<Queue>());
+            }
+
+            m_Threads.reserve(workers);
+            for(std::size_t index = 0; index < workers; ++index) {
+                m_Threads.emplace_back(&JobSystem::WorkerLoop, this, index + 1);
+            }
+        }
+
+        /**
+        * @brief Stop the worker threads
+        * @note All jobs that are still in the queues are executed before the workers stop
+        */
+        void Stop()
+        {
+            Wait();
+
+            if(!m_Running) {
+                return;
+            }
+
+            m_Running.store(false, std::memory_order_relaxed);
+            m_Signal.fetch_add(1, std::memory_order_release);
+            m_Signal.notify_all();
+
+            for(auto& thread : m_Threads) {
+                thread.join();
+            }
+
+            m_Threads.clear();
+            m_Queues.resize(1);
+        }
+
+        [[nodiscard]] bool Running() const noexcept {
+            return m_Running.load(std::memory_order_relaxed);
+        }
+
+        [[nodiscard]] std::size_t Workers() const noexcept {
+            return m_Threads.size();
+        }
+
+        [[nodiscard]] std::size_t Pending() const noexcept {
+            return m_Pending.load(std::memory_order_relaxed);
+        }
+
+        /**
+        * @brief Submit the job
+        * @param func Callable object
+        * @param args Arguments passed to the callable object
+        * @return Future with the result of the job
+        * @warning Use Wait(future) instead of future.get() on the engine thread,
+        * otherwise with zero workers nobody will execute the job
+        */
+        template <typename Func, typename... Args>
+        requires std::invocable<Func, Args...>
+        [[nodiscard]] auto Submit(Func&& func, Args&&... args) -> std::future<std::invoke_result_t<Func, Args...>>
+        {
+            using Result = std::invoke_result_t<Func, Args...>;
+
+            auto task = std::make_shared<std::packaged_task<Result ()>>(
+                [func = std::forward<Func>(func), ...args = std::forward<Args>(args)]() mutable -> Result {
+                    return std::invoke(std::move(func), std::move(args)...);
+            });
+
+            auto future = task->get_future();
+            Push([task = std::move(task)]() { (*task)(); });
+            return future;
+        }
+
+        /**
+        * @brief Execute the function for each index in range [begin, end)
+        * @param begin First index
+        * @param end Last index (exclusive)
+        * @param func Callable object with signature void(std::size_t)
+        * @param grain Number of indexes per job, 0 for auto
+        * @note
+        * The calling thread participates in execution and returns when all indexes are processed.
+        * The first exception thrown by the function is rethrown by the calling thread after all jobs are finished,
+        * the chunks not started yet are skipped.
+        */
+        template <typename Func>
+        requires std::invocable<Func&, std::size_t>
+        void ParallelFor(std::size_t begin, std::size_t end, Func&& func, std::size_t grain = 0)
+        {
+            if(begin >= end) {
+                return;
+            }
+
+            const auto count = end - begin;
+            if(!grain) {
+                grain = (std::max)(std::size_t{1}, count / ((Workers() + 1) * 4));
+            }
+
+            const auto chunks = (count + grain - 1) / grain;
+            std::atomic<std::size_t> remaining{chunks};
+            std::atomic_flag failed{};
+            std::exception_ptr exception{};
+
+            // Jobs reference the locals: the exception is kept until all chunks are finished
+            const auto fnChunk = [&func, &remaining, &failed, &exception, begin, end, grain](std::size_t chunk) {
+                if(!failed.test(std::memory_order_relaxed)) {
+                    try {
+                        const auto from = begin + chunk * grain;
+                        const auto to = (std::min)(end, from + grain);
+                        for(auto index = from; index < to; ++index) {
+                            func(index);
+                        }
+                    } catch(...) {
+                        if(!failed.test_and_set(std::memory_order_relaxed)) {
+                            exception = std::current_exception();
+                        }
+                    }
+                }
+
+                remaining.fetch_sub(1, std::memory_order_release);
+            };
+
+            for(std::size_t chunk = 1; chunk < chunks; ++chunk) {
+                Push([&fnChunk, chunk]() { fnChunk(chunk); });
+            }
+
+            fnChunk(0);
+
+            while(remaining.load(std::memory_order_acquire)) {
+                if(!Execute(CurrentQueue())) {
+                    std::this_thread::yield();
+                }
+            }
+
+            if(exception) {
+                std::rethrow_exception(exception);
+            }
+        }
+
+        /**
+        * @brief Wait for all submitted jobs
+        * @note
+        * The calling thread participates in execution.
+        * Called from a job, it does not wait for the jobs running on the calling thread
+        * and for the jobs blocked in Wait on other threads, otherwise these jobs would wait for each other.
+        */
+        void Wait()
+        {
+            auto& jobs = m_ThreadJobs;
+            const auto own = jobs.m_Owner == this ? jobs.m_Depth - jobs.m_Blocked : 0;
+            if(own) {
+                jobs.m_Blocked += own;
+                m_Blocked.fetch_add(own, std::memory_order_acq_rel);
+            }
+
+            // Outside of the jobs nothing is excluded: all jobs are finished
+            const auto fnExcluded = [this, &jobs]() noexcept -> std::size_t {
+                return jobs.m_Owner == this && jobs.m_Blocked ? m_Blocked.load(std::memory_order_acquire) : 0;
+            };
+
+            while(true)
+            {
+                // The blocked jobs are read first: a job released meanwhile is still pending
+                const auto excluded = fnExcluded();
+                if(m_Pending.load(std::memory_order_acquire) <= excluded) {
+                    break;
+                }
+
+                if(!Execute(CurrentQueue())) {
+                    std::this_thread::yield();
+                }
+            }
+
+            if(own) {
+                m_Blocked.fetch_sub(own, std::memory_order_acq_rel);
+                jobs.m_Blocked -= own;
+            }
+        }
+
+        /**
+        * @brief Wait for the future of the job
+        * @param future Future returned by Submit
+        * @note The calling thread participates in execution
+        */
+        template <typename T>
+        void Wait(const std::future<T>& future)
+        {
+            while(future.wait_for(std::chrono::seconds::zero()) != std::future_status::ready) {
+                if(!Execute(CurrentQueue())) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+    private:
+        [[nodiscard]] std::size_t CurrentQueue() const noexcept {
+            return m_CurrentOwner == this ? m_CurrentQueue : 0;
+        }
+
+        void Push(Job job)
+        {
+            m_Pending.fetch_add(1, std::memory_order_relaxed);
+
+            {
+                auto& queue = *m_Queues[CurrentQueue()];
+                std::lock_guard lock{queue.m_Lock};
+                queue.m_Jobs.emplace_back(std::move(job));
+            }
+
+            m_Signal.fetch_add(1, std::memory_order_release);
+            m_Signal.notify_one();
+        }
+
+        [[nodiscard]] bool Execute(std::size_t index)
+        {
+            Job job;
+
+            {
+                auto& queue = *m_Queues[index];
+                std::lock_guard lock{queue.m_Lock};
+                if(!queue.m_Jobs.empty()) {
+                    job = std::move(queue.m_Jobs.back());
+                    queue.m_Jobs.pop_back();
+                }
+            }
+
+            for(std::size_t offset = 1; !job && offset < m_Queues.size(); ++offset)
+            {
+                auto& queue = *m_Queues[(index + offset) % m_Queues.size()];
+                if(!queue.m_Lock.TryLock()) {
+                    continue;
+                }
+
+                if(!queue.m_Jobs.empty()) {
+                    job = std::move(queue.m_Jobs.front());
+                    queue.m_Jobs.pop_front();
+                }
+
+                queue.m_Lock.Unlock();
+            }
+
+            if(!job) {
+                return false;
+            }
+
+            const auto jobs = m_ThreadJobs;
+            m_ThreadJobs = jobs.m_Owner == this ? ThreadJobs{this, jobs.m_Depth + 1, jobs.m_Blocked} : ThreadJobs{this, 1, 0};
+            job();
+            m_ThreadJobs = jobs;
+
+            m_Pending.fetch_sub(1, std::memory_order_release);
+            return true;
+        }
+
+        void WorkerLoop(std::size_t index)
+        {
+            m_CurrentOwner = this;
+            m_CurrentQueue = index;
+
+            while(true)
+            {
+                const auto signal = m_Signal.load(std::memory_order_acquire);
+                if(Execute(index)) {
+                    continue;
+                }
+
+                if(!m_Running.load(std::memory_order_relaxed)) {
+                    break;
+                }
+
+                m_Signal.wait(signal, std::memory_order_acquire);
+            }
+
+            m_CurrentOwner = nullptr;
+        }
+
+    private:
+        std::vector<std::unique_ptr<Queue>> m_Queues;
+        std::vector<std::thread> m_Threads;
+        alignas(Traits::Cacheline) std::atomic<std::size_t> m_Pending;
+        std::atomic<std::size_t> m_Blocked;     // Running jobs blocked in Wait
+        alignas(Traits::Cacheline) std::atomic<std::uint32_t> m_Signal;
+        std::atomic<bool> m_Running;
+
+        inline static thread_local const JobSystem* m_CurrentOwner {};
+        inline static thread_local std::size_t m_CurrentQueue {};
+        inline static thread_local ThreadJobs m_ThreadJobs {};
+    };
+}
+
+#endif // HELENA_TYPES_JOBSYSTEM_HPP
@@ -0,0 +1,151 @@
+#ifndef HELENA_TYPES_MPSCQUEUE_HPP
+#define HELENA_TYPES_MPSCQUEUE_HPP
+
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Traits/Cacheline.hpp>
+#include <Helena/Traits/PowerOf2.hpp>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Bounded lock-free multi-producer single-consumer queue
+    * @tparam T Type of elements
+    * @tparam Capacity Number of slots (rounded up to a power of 2)
+    * @note
+    * Ring of slots with sequence numbers (D. Vyukov bounded queue):
+    * producers claim the slot with CAS on the head, the single consumer reads the tail without atomics RMW.
+    * Elements are constructed in place and consumed in place, T does not have to be movable.
+    * The construction should not throw: the claimed slot cannot be returned and would block the consumer.
+    */
+    template <typename T, std::size_t Capacity>
+    class MPSCQueue final
+    {
+        static constexpr auto Size = Traits::PowerOf2<Capacity>::value;
+        static constexpr auto Mask = Size - 1;
+
+        static_assert(Capacity > 1, "Capacity should be greater than 1");
+
+        struct Cell {
+            std::atomic<std::size_t> m_Sequence;
+            alignas(T) std::byte m_Storage[sizeof(T)];
+        };
+
+    public:
+        MPSCQueue() : m_Cells{std::make_unique<Cell[]>(Size)}, m_Head{}, m_Tail{}
+        {
+            for(std::size_t index = 0; index < Size; ++index) {
+                m_Cells[index].m_Sequence.store(index, std::memory_order_relaxed);
+            }
+        }
+
+        ~MPSCQueue() {
+            while(TryPop([](T&) {})) {}
+        }
+
+        MPSCQueue(const MPSCQueue&) = delete;
+        MPSCQueue(MPSCQueue&&) noexcept = delete;
+        MPSCQueue& operator=(const MPSCQueue&) = delete;
+        MPSCQueue& operator=(MPSCQueue&&) noexcept = delete;
+
+        /**
+        * @brief Construct the element in the queue (thread safe)
+        * @param args Arguments for construct the element
+        * @return False if the queue is full
+        */
+        template <typename... Args>
+        requires std::is_nothrow_constructible_v<T, Args...>
+        [[nodiscard]] bool TryPush(Args&&... args)
+        {
+            auto pos = m_Head.load(std::memory_order_relaxed);
+
+            while(true)
+            {
+                auto& cell = m_Cells[pos & Mask];
+                const auto sequence = cell.m_Sequence.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos);
+
+                if(!diff)
+                {
+                    if(m_Head.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                        new (&cell.m_Storage) T(std::forward<Args>(args)...);
+                        cell.m_Sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if(diff < 0) {
+                    // The consumer has not released the slot yet: the queue is full
+                    return false;
+                } else {
+                    pos = m_Head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+        * @brief Consume the element from the queue (consumer thread only)
+        * @param func Callable object with signature void(T&)
+        * @return False if the queue is empty
+        * @note The element is destroyed after the callback
+        */
+        template <typename Func>
+        requires std::is_invocable_v<Func, T&>
+        bool TryPop(Func&& func)
+        {
+            const auto pos = m_Tail.load(std::memory_order_relaxed);
+            auto& cell = m_Cells[pos & Mask];
+            if(cell.m_Sequence.load(std::memory_order_acquire) != pos + 1) {
+                return false;
+            }
+
+            auto* element = std::launder(reinterpret_cast<T*>(&cell.m_Storage));
+            func(*element);
+            std::destroy_at(element);
+
+            cell.m_Sequence.store(pos + Size, std::memory_order_release);
+            m_Tail.store(pos + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /**
+        * @brief Returns the number of pushed elements since creation
+        */
+        [[nodiscard]] std::size_t Pushed() const noexcept {
+            return m_Head.load(std::memory_order_relaxed);
+        }
+
+        /**
+        * @brief Returns the number of consumed elements since creation
+        */
+        [[nodiscard]] std::size_t Popped() const noexcept {
+            return m_Tail.load(std::memory_order_relaxed);
+        }
+
+        /**
+        * @brief Returns the approximate number of elements in the queue
+        * @note Claimed slots are counted even if the producer has not finished the construction
+        */
+        [[nodiscard]] std::size_t Count() const noexcept {
+            const auto tail = Popped();
+            const auto head = Pushed();
+            return head > tail ? head - tail : 0;
+        }
+
+        [[nodiscard]] static constexpr std::size_t GetCapacity() noexcept {
+            return Size;
+        }
+
+    private:
+        std::unique_ptr<Cell[]> m_Cells;
+        alignas(Traits::Cacheline) std::atomic<std::size_t> m_Head;
+        alignas(Traits::Cacheline) std::atomic<std::size_t> m_Tail;
+    };
+}
+
+#endif // HELENA_TYPES_MPSCQUEUE_HPP
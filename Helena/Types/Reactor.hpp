@@ -0,0 +1,229 @@
+#ifndef HELENA_TYPES_REACTOR_HPP
+#define HELENA_TYPES_REACTOR_HPP
+
+#include <Helena/Platform/Platform.hpp>
+
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+
+#if defined(HELENA_PLATFORM_LINUX)
+    #include <pthread.h>
+    #include <sys/epoll.h>
+    #include <sys/eventfd.h>
+    #include <sys/signalfd.h>
+    #include <sys/timerfd.h>
+    #include <unistd.h>
+#endif
+
+namespace Helena::Types
+{
+    /**
+    * @brief Blocking wait for the deadline, the notification from other threads or the termination signal
+    * @note
+    * Linux: the thread blocks in epoll_wait on the timerfd (absolute CLOCK_MONOTONIC deadline),
+    * the eventfd (Notify) and the signalfd (SIGINT, SIGTERM, SIGHUP blocked in the opening thread).
+    * Notify writes the eventfd only when the thread is waiting or about to wait, the other calls are a single atomic load.
+    * Other platforms: Open returns false, the caller uses its own sleep.
+    */
+    class Reactor final
+    {
+    public:
+        //! Reason of the wakeup
+        enum class EWakeup : std::uint8_t
+        {
+            Timer,      // Deadline reached
+            Notify,     // Notified by Notify or the pending work was found before the wait
+            Signal,     // Termination signal received by the signalfd
+            Error       // Wait failed
+        };
+
+    public:
+        Reactor() noexcept = default;
+        ~Reactor() {
+            Close();
+        }
+
+        Reactor(const Reactor&) = delete;
+        Reactor(Reactor&&) noexcept = delete;
+        Reactor& operator=(const Reactor&) = delete;
+        Reactor& operator=(Reactor&&) noexcept = delete;
+
+        /**
+        * @brief Create the descriptors, does nothing if already opened
+        * @param signals Receive SIGINT, SIGTERM and SIGHUP by the signalfd
+        * @return False if the reactor is not supported or the descriptors can't be created
+        * @note
+        * The signals are blocked in the calling thread, threads created later inherit the mask.
+        * Call it before starting other threads, otherwise they can receive the signals.
+        */
+        [[nodiscard]] bool Open([[maybe_unused]] bool signals)
+        {
+        #if defined(HELENA_PLATFORM_LINUX)
+            if(m_Epoll >= 0) {
+                return true;
+            }
+
+            m_Epoll = epoll_create1(EPOLL_CLOEXEC);
+            m_Timer = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+            m_Event = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+
+            if(m_Epoll < 0 || m_Timer < 0 || m_Event < 0 || !Watch(m_Timer) || !Watch(m_Event)) {
+                Close();
+                return false;
+            }
+
+            if(signals)
+            {
+                sigset_t mask;
+                sigemptyset(&mask);
+                sigaddset(&mask, SIGINT);
+                sigaddset(&mask, SIGTERM);
+                sigaddset(&mask, SIGHUP);
+
+                if(pthread_sigmask(SIG_BLOCK, &mask, &m_SignalMask)) {
+                    Close();
+                    return false;
+                }
+
+                m_SignalBlocked = true;
+                m_Signal = signalfd(-1, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+                if(m_Signal < 0 || !Watch(m_Signal)) {
+                    Close();
+                    return false;
+                }
+            }
+
+            return true;
+        #else
+            return false;
+        #endif
+        }
+
+        /**
+        * @brief Close the descriptors and restore the signal mask of the calling thread
+        */
+        void Close() noexcept
+        {
+        #if defined(HELENA_PLATFORM_LINUX)
+            for(auto* fd : {&m_Signal, &m_Event, &m_Timer, &m_Epoll}) {
+                if(*fd >= 0) {
+                    close(*fd);
+                    *fd = -1;
+                }
+            }
+
+            if(m_SignalBlocked) {
+                pthread_sigmask(SIG_SETMASK, &m_SignalMask, nullptr);
+                m_SignalBlocked = false;
+            }
+        #endif
+        }
+
+        [[nodiscard]] bool IsOpen() const noexcept {
+        #if defined(HELENA_PLATFORM_LINUX)
+            return m_Epoll >= 0;
+        #else
+            return false;
+        #endif
+        }
+
+        /**
+        * @brief Wake up the waiting thread (thread safe, async-signal-safe)
+        * @note Call it after publishing the work checked by the pending function of Wait
+        */
+        void Notify() noexcept
+        {
+        #if defined(HELENA_PLATFORM_LINUX)
+            // Pairs with the fence in Wait: either the waiter sees the work or we see the waiter
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(m_Waiting.load(std::memory_order_relaxed) && m_Waiting.exchange(false, std::memory_order_relaxed)) {
+                const std::uint64_t value = 1;
+                [[maybe_unused]] const auto result = write(m_Event, &value, sizeof(value));
+            }
+        #endif
+        }
+
+        /**
+        * @brief Wait until the deadline, the notification or the signal
+        * @tparam Func Type of callable object
+        * @param deadline Time point of steady_clock (CLOCK_MONOTONIC)
+        * @param pending Callable object with signature bool(), returns true if the work is already published
+        * @return Reason of the wakeup
+        */
+        template <typename Func>
+        [[nodiscard]] EWakeup Wait([[maybe_unused]] std::chrono::steady_clock::time_point deadline, [[maybe_unused]] Func&& pending)
+        {
+        #if defined(HELENA_PLATFORM_LINUX)
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline.time_since_epoch()).count();
+            const itimerspec spec {
+                .it_interval = {},
+                .it_value = {
+                    .tv_sec = static_cast<time_t>(ns / 1'000'000'000),
+                    // Zero disarms the timer: the deadline at the epoch is in the past anyway
+                    .tv_nsec = static_cast<long>(ns % 1'000'000'000) + (ns <= 0)
+                }
+            };
+
+            if(timerfd_settime(m_Timer, TFD_TIMER_ABSTIME, &spec, nullptr)) {
+                return EWakeup::Error;
+            }
+
+            m_Waiting.store(true, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if(pending()) {
+                m_Waiting.store(false, std::memory_order_relaxed);
+                return EWakeup::Notify;
+            }
+
+            epoll_event events[3];
+            auto count = 0;
+            while((count = epoll_wait(m_Epoll, events, 3, -1)) < 0 && errno == EINTR) {}
+            m_Waiting.store(false, std::memory_order_relaxed);
+
+            if(count < 0) {
+                return EWakeup::Error;
+            }
+
+            auto wakeup = EWakeup::Timer;
+            for(auto index = 0; index < count; ++index)
+            {
+                std::uint64_t value{};
+                if(events[index].data.fd == m_Signal) {
+                    signalfd_siginfo info{};
+                    while(read(m_Signal, &info, sizeof(info)) == sizeof(info)) {}
+                    return EWakeup::Signal;
+                } else if(events[index].data.fd == m_Event) {
+                    [[maybe_unused]] const auto result = read(m_Event, &value, sizeof(value));
+                    wakeup = EWakeup::Notify;
+                } else {
+                    [[maybe_unused]] const auto result = read(m_Timer, &value, sizeof(value));
+                }
+            }
+
+            return wakeup;
+        #else
+            return EWakeup::Error;
+        #endif
+        }
+
+    private:
+    #if defined(HELENA_PLATFORM_LINUX)
+        [[nodiscard]] bool Watch(int fd) noexcept {
+            epoll_event event{.events = EPOLLIN, .data = {.fd = fd}};
+            return !epoll_ctl(m_Epoll, EPOLL_CTL_ADD, fd, &event);
+        }
+
+        int m_Epoll {-1};
+        int m_Timer {-1};
+        int m_Event {-1};
+        int m_Signal {-1};
+        sigset_t m_SignalMask {};
+        bool m_SignalBlocked {};
+    #endif
+        std::atomic<bool> m_Waiting {};
+    };
+}
+
+#endif // HELENA_TYPES_REACTOR_HPP
@@ -0,0 +1,249 @@
+#ifndef HELENA_TYPES_SHARDEDTASKSCHEDULER_HPP
+#define HELENA_TYPES_SHARDEDTASKSCHEDULER_HPP
+
+#include <Helena/Engine/Log.hpp>
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Traits/Cacheline.hpp>
+#include <Helena/Types/MPSCQueue.hpp>
+#include <Helena/Types/TaskScheduler.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Task scheduler split into shards updated by the different threads
+    * @tparam Backend Queue of the tasks of the shard: TaskQueueSorted or TaskQueueWheel
+    * @tparam TimeSource Clock of the shards: TaskClockPrecise or TaskClockCoarse
+    * @tparam MailboxSize Capacity of the command queue of the shard
+    * @note
+    * The task belongs to the shard selected by the hash of the id.
+    * Create, Modify and Remove are thread safe: the command is pushed into the lock-free mailbox of the shard
+    * and applied by the next Update of the shard (the delay is counted from this Update).
+    * Commands of one thread to the same shard are applied in the order of the calls.
+    * Update of the shard is called by one thread at a time, the callbacks of the shard run in this thread.
+    * @code{.cpp}
+    * Types::ShardedTaskScheduler<> scheduler{workers};
+    * scheduler.Create(entity, 1000, [](std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat) {});
+    * jobs.ParallelFor(0, scheduler.Shards(), [&](std::size_t shard) { scheduler.Update(shard); }, 1);
+    * @endcode
+    */
+    template <typename Backend = TaskQueueWheel<>, typename TimeSource = TaskClockPrecise, std::size_t MailboxSize = 4096>
+    class ShardedTaskScheduler final
+    {
+    public:
+        using Scheduler = BasicTaskScheduler<Backend, TimeSource>;
+        using Callback = typename Scheduler::Callback;
+        using Nano = std::chrono::duration<std::uint64_t, std::nano>;
+
+        //! Attempts to push the command into the full mailbox before the failure
+        static constexpr std::uint32_t Retries = 64;
+
+    private:
+        enum class ECommand : std::uint8_t {
+            Create,
+            Modify,
+            Remove
+        };
+
+        struct Command {
+            Command(ECommand type, std::uint64_t id, Nano delay, std::uint32_t repeat, bool update, Callback&& callback) noexcept
+                : m_Callback{std::move(callback)}, m_Id{id}, m_Delay{delay}, m_Repeat{repeat}, m_Type{type}, m_Update{update} {}
+            ~Command() = default;
+            Command(const Command&) = delete;
+            Command(Command&&) noexcept = delete;
+            Command& operator=(const Command&) = delete;
+            Command& operator=(Command&&) noexcept = delete;
+
+            Callback m_Callback;
+            std::uint64_t m_Id;
+            Nano m_Delay;
+            std::uint32_t m_Repeat;
+            ECommand m_Type;
+            bool m_Update;
+        };
+
+        struct alignas(Traits::Cacheline) Shard {
+            Scheduler m_Scheduler;
+            MPSCQueue<Command, MailboxSize> m_Mailbox;
+        };
+
+    public:
+        /**
+        * @brief Create the scheduler
+        * @param shards Number of shards, usually the number of threads calling Update
+        */
+        explicit ShardedTaskScheduler(std::size_t shards)
+            : m_Shards{std::make_unique<Shard[]>((std::max)(std::size_t{1}, shards))}
+            , m_Count{(std::max)(std::size_t{1}, shards)} {}
+
+        ~ShardedTaskScheduler() = default;
+        ShardedTaskScheduler(const ShardedTaskScheduler&) = delete;
+        ShardedTaskScheduler(ShardedTaskScheduler&&) noexcept = delete;
+        ShardedTaskScheduler& operator=(const ShardedTaskScheduler&) = delete;
+        ShardedTaskScheduler& operator=(ShardedTaskScheduler&&) noexcept = delete;
+
+        /**
+        * @brief Create the task (thread safe)
+        * @return False if the mailbox of the shard is full
+        * @note The duplicate id is reported by the shard when the command is applied
+        */
+        template <typename Rep, typename Period, typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        [[nodiscard]] bool Create(std::uint64_t id, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat, Func&& cb, Args&&... args)
+        {
+            HELENA_ASSERT(repeat, "Repeat is null");
+
+            if constexpr(!sizeof...(Args) && std::is_same_v<std::decay_t<Func>, Callback>) {
+                return Push(ECommand::Create, id, ToNano(delay), repeat, false, std::forward<Func>(cb));
+            } else {
+                return Push(ECommand::Create, id, ToNano(delay), repeat, false, Callback{
+                    [cb = std::forward<decltype(cb)>(cb), ...args = std::forward<Args>(args)]
+                    (std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat) mutable {
+                        std::forward<decltype(cb)>(cb)(id, ms, repeat, std::forward<Args>(args)...);
+                }});
+            }
+        }
+
+        template <typename Rep, typename Period, typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        [[nodiscard]] bool Create(std::uint64_t id, std::chrono::duration<Rep, Period> delay, Func&& cb, Args&&... args) {
+            return Create(id, delay, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
+
+        template <typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        [[nodiscard]] bool Create(std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, Func&& cb, Args&&... args) {
+            return Create(id, std::chrono::milliseconds{ms}, repeat, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
+
+        template <typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        [[nodiscard]] bool Create(std::uint64_t id, std::uint64_t ms, Func&& cb, Args&&... args) {
+            return Create(id, std::chrono::milliseconds{ms}, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
+
+        /**
+        * @brief Modify the task (thread safe)
+        * @return False if the mailbox of the shard is full
+        */
+        template <typename Rep, typename Period>
+        [[nodiscard]] bool Modify(std::uint64_t id, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat, bool update) {
+            HELENA_ASSERT(repeat);
+            return Push(ECommand::Modify, id, ToNano(delay), repeat, update, Callback{});
+        }
+
+        [[nodiscard]] bool Modify(std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, bool update) {
+            return Modify(id, std::chrono::milliseconds{ms}, repeat, update);
+        }
+
+        /**
+        * @brief Remove the task (thread safe)
+        * @return False if the mailbox of the shard is full
+        */
+        [[nodiscard]] bool Remove(std::uint64_t id) {
+            return Push(ECommand::Remove, id, Nano{}, 0, false, Callback{});
+        }
+
+        /**
+        * @brief Apply the commands of the mailbox and fire the expired tasks of the shard
+        * @param shard Index of the shard
+        */
+        void Update(std::size_t shard) {
+            Update(shard, TimeSource::Now());
+        }
+
+        /**
+        * @brief Apply the commands of the mailbox and fire the tasks of the shard expired at the time
+        * @param shard Index of the shard
+        * @param timeNow Time in nanoseconds of the TimeSource
+        */
+        void Update(std::size_t shard, std::uint64_t timeNow)
+        {
+            HELENA_ASSERT(shard < m_Count, "Shard out of bounds");
+
+            auto& [scheduler, mailbox] = m_Shards[shard];
+            const auto fnApply = [&scheduler](Command& command) {
+                switch(command.m_Type) {
+                    case ECommand::Create: scheduler.Create(command.m_Id, command.m_Delay, command.m_Repeat, std::move(command.m_Callback)); break;
+                    case ECommand::Modify: scheduler.Modify(command.m_Id, command.m_Delay, command.m_Repeat, command.m_Update); break;
+                    case ECommand::Remove: scheduler.Remove(command.m_Id); break;
+                }
+            };
+
+            // Bounded: the commands pushed by the callbacks are applied by the next Update
+            for(auto count = mailbox.Count(); count; --count) {
+                if(!mailbox.TryPop(fnApply)) {
+                    break;
+                }
+            }
+
+            scheduler.Update(timeNow);
+        }
+
+        /**
+        * @brief Returns the scheduler of the shard
+        * @note Use it only from the thread updating the shard, e.g. by the callbacks of the shard
+        */
+        [[nodiscard]] Scheduler& GetShard(std::size_t shard) noexcept {
+            HELENA_ASSERT(shard < m_Count, "Shard out of bounds");
+            return m_Shards[shard].m_Scheduler;
+        }
+
+        [[nodiscard]] std::size_t ShardOf(std::uint64_t id) const noexcept {
+            return static_cast<std::size_t>(((id * 0x9E3779B97F4A7C15ull) >> 32) % m_Count);
+        }
+
+        [[nodiscard]] std::size_t Shards() const noexcept {
+            return m_Count;
+        }
+
+        /**
+        * @brief Returns the approximate number of commands waiting in the mailbox of the shard
+        */
+        [[nodiscard]] std::size_t Pending(std::size_t shard) const noexcept {
+            HELENA_ASSERT(shard < m_Count, "Shard out of bounds");
+            return m_Shards[shard].m_Mailbox.Count();
+        }
+
+    private:
+        template <typename Rep, typename Period>
+        [[nodiscard]] static Nano ToNano(std::chrono::duration<Rep, Period> delay) noexcept {
+            const auto nano = std::chrono::ceil<std::chrono::nanoseconds>(delay).count();
+            return Nano{nano > 0 ? static_cast<std::uint64_t>(nano) : 0};
+        }
+
+        [[nodiscard]] bool Push(ECommand type, std::uint64_t id, Nano delay, std::uint32_t repeat, bool update, Callback&& callback)
+        {
+            auto& mailbox = m_Shards[ShardOf(id)].m_Mailbox;
+            for(std::uint32_t retry = 0;; ++retry)
+            {
+                // The callback is moved only when the slot is claimed
+                if(mailbox.TryPush(type, id, delay, repeat, update, std::move(callback))) {
+                    return true;
+                }
+
+                if(retry == Retries) {
+                    HELENA_MSG_WARNING("TaskID: {} command dropped, mailbox of the shard is full!", id);
+                    return false;
+                }
+
+                std::this_thread::yield();
+            }
+        }
+
+    private:
+        std::unique_ptr<Shard[]> m_Shards;
+        std::size_t m_Count;
+    };
+}
+
+#endif // HELENA_TYPES_SHARDEDTASKSCHEDULER_HPP
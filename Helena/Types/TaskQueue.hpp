@@ -0,0 +1,494 @@
+#ifndef HELENA_TYPES_TASKQUEUE_HPP
+#define HELENA_TYPES_TASKQUEUE_HPP
+
+#include <Helena/Platform/Assert.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Backend of BasicTaskScheduler: indexed binary heap of the tasks ordered by the expiration time
+    * @note
+    * Tasks are fired exactly in the order of the expiration time, the tasks of the same time in the order of insertion.
+    * The hook keeps the position of the task in the heap: Insert and Erase are O(log n) without search,
+    * even when many tasks share the same expiration time.
+    * InsertMany and EraseMany rebuild the heap once in O(n) when the batch is large relative to the queue.
+    */
+    struct TaskQueueSorted
+    {
+        template <typename Task>
+        struct Hook {
+            std::size_t m_Index {};
+            std::uint64_t m_Sequence {};
+        };
+
+        template <typename Task>
+        class Queue
+        {
+            struct Node {
+                std::uint64_t m_Time;
+                std::uint64_t m_Sequence;
+                Task* m_Task;
+            };
+
+            [[nodiscard]] static bool Less(const Node& lhs, const Node& rhs) noexcept {
+                return lhs.m_Time < rhs.m_Time || (lhs.m_Time == rhs.m_Time && lhs.m_Sequence < rhs.m_Sequence);
+            }
+
+        public:
+            Queue() : m_Nodes{}, m_Sequence{} {}
+            ~Queue() = default;
+            Queue(const Queue&) = delete;
+            Queue(Queue&&) noexcept = default;
+            Queue& operator=(const Queue&) = delete;
+            Queue& operator=(Queue&&) noexcept = default;
+
+            void Insert(Task& task, [[maybe_unused]] std::uint64_t timeNow)
+            {
+                task.m_Hook.m_Sequence = m_Sequence++;
+                m_Nodes.push_back(Node{task.m_Expired, task.m_Hook.m_Sequence, &task});
+                SiftUp(m_Nodes.size() - 1);
+            }
+
+            void Erase(Task& task) noexcept
+            {
+                const auto index = task.m_Hook.m_Index;
+                HELENA_ASSERT(index < m_Nodes.size() && m_Nodes[index].m_Task == &task, "Task not found");
+
+                const auto last = m_Nodes.size() - 1;
+                if(index != last)
+                {
+                    Place(index, m_Nodes[last]);
+                    m_Nodes.pop_back();
+
+                    if(index && Less(m_Nodes[index], m_Nodes[(index - 1) / 2])) {
+                        SiftUp(index);
+                    } else {
+                        SiftDown(index);
+                    }
+
+                    return;
+                }
+
+                m_Nodes.pop_back();
+            }
+
+            void InsertMany(std::span<Task* const> tasks, [[maybe_unused]] std::uint64_t timeNow)
+            {
+                const auto size = m_Nodes.size();
+                m_Nodes.reserve(size + tasks.size());
+                for(auto* task : tasks) {
+                    task->m_Hook.m_Sequence = m_Sequence++;
+                    m_Nodes.push_back(Node{task->m_Expired, task->m_Hook.m_Sequence, task});
+                }
+
+                if(IsBulk(tasks.size())) {
+                    Rebuild();
+                    return;
+                }
+
+                for(auto index = size; index < m_Nodes.size(); ++index) {
+                    SiftUp(index);
+                }
+            }
+
+            /**
+            * @brief Erase the batch of tasks
+            * @param tasks Tasks of the queue
+            * @param fnErased Called for each task when the queue is consistent without it
+            */
+            template <typename Func>
+            void EraseMany(std::span<Task* const> tasks, Func&& fnErased)
+            {
+                if(!IsBulk(tasks.size())) {
+                    for(auto* task : tasks) {
+                        Erase(*task);
+                        fnErased(*task);
+                    }
+
+                    return;
+                }
+
+                for(auto* task : tasks) {
+                    HELENA_ASSERT(task->m_Hook.m_Index < m_Nodes.size() && m_Nodes[task->m_Hook.m_Index].m_Task == task, "Task not found");
+                    m_Nodes[task->m_Hook.m_Index].m_Task = nullptr;
+                }
+
+                std::erase_if(m_Nodes, [](const Node& node) { return !node.m_Task; });
+                Rebuild();
+
+                for(auto* task : tasks) {
+                    fnErased(*task);
+                }
+            }
+
+            [[nodiscard]] Task* Front(std::uint64_t timeNow) const noexcept {
+                return !m_Nodes.empty() && m_Nodes.front().m_Time <= timeNow ? m_Nodes.front().m_Task : nullptr;
+            }
+
+            [[nodiscard]] std::uint64_t NextTime() const noexcept {
+                return m_Nodes.empty() ? (std::numeric_limits<std::uint64_t>::max)() : m_Nodes.front().m_Time;
+            }
+
+            void Clear() noexcept {
+                m_Nodes.clear();
+            }
+
+            //! Sift of each task of the batch costs more than the heap construction over the whole queue
+            [[nodiscard]] bool IsBulk(std::size_t count) const noexcept {
+                return count * static_cast<std::size_t>(std::bit_width(m_Nodes.size())) > m_Nodes.size() * 2;
+            }
+
+        private:
+
+            // Floyd's heap construction: O(n)
+            void Rebuild() noexcept
+            {
+                for(std::size_t index = 0; index < m_Nodes.size(); ++index) {
+                    m_Nodes[index].m_Task->m_Hook.m_Index = index;
+                }
+
+                for(auto index = m_Nodes.size() / 2; index--;) {
+                    SiftDown(index);
+                }
+            }
+
+            void Place(std::size_t index, const Node& node) noexcept {
+                m_Nodes[index] = node;
+                node.m_Task->m_Hook.m_Index = index;
+            }
+
+            void SiftUp(std::size_t index) noexcept
+            {
+                const auto node = m_Nodes[index];
+                while(index)
+                {
+                    const auto parent = (index - 1) / 2;
+                    if(!Less(node, m_Nodes[parent])) {
+                        break;
+                    }
+
+                    Place(index, m_Nodes[parent]);
+                    index = parent;
+                }
+
+                Place(index, node);
+            }
+
+            void SiftDown(std::size_t index) noexcept
+            {
+                const auto node = m_Nodes[index];
+                const auto size = m_Nodes.size();
+                while(true)
+                {
+                    auto child = index * 2 + 1;
+                    if(child >= size) {
+                        break;
+                    }
+
+                    if(child + 1 < size && Less(m_Nodes[child + 1], m_Nodes[child])) {
+                        ++child;
+                    }
+
+                    if(!Less(m_Nodes[child], node)) {
+                        break;
+                    }
+
+                    Place(index, m_Nodes[child]);
+                    index = child;
+                }
+
+                Place(index, node);
+            }
+
+        private:
+            std::vector<Node> m_Nodes;
+            std::uint64_t m_Sequence;   // Order of insertion for the tasks of the same time
+        };
+    };
+
+    /**
+    * @brief Backend of BasicTaskScheduler: hierarchical timing wheel
+    * @tparam Resolution Tick of the wheel in nanoseconds
+    * @note
+    * 4 levels of 256 slots (1 ms resolution: 256 ms, 65 s, 4.6 hours, 49.7 days, later tasks are cascaded again).
+    * Tasks are linked into the slots by the intrusive hooks: Insert and Erase are O(1) without allocations,
+    * expiration is amortized O(1), the empty slots are skipped by the occupancy bitmaps.
+    * Tasks are never fired before the expiration time and at most one tick later.
+    * The order of the tasks of the same tick is unspecified: the tasks cascaded from the upper levels
+    * are fired after the tasks placed directly into the level 0, use TaskQueueSorted for the strict order.
+    */
+    template <std::uint64_t Resolution = 1'000'000>
+    struct TaskQueueWheel
+    {
+        static_assert(Resolution > 0, "Resolution is null");
+
+        template <typename Task>
+        struct Hook {
+            Task* m_Prev {};
+            Task* m_Next {};
+            std::uint64_t m_Tick {};
+            std::uint32_t m_List {};
+        };
+
+        template <typename Task>
+        class Queue
+        {
+            static constexpr std::uint32_t Bits = 8;
+            static constexpr std::uint32_t Slots = 1u << Bits;
+            static constexpr std::uint32_t Mask = Slots - 1;
+            static constexpr std::uint32_t Levels = 4;
+            static constexpr std::uint32_t Due = Levels * Slots;     // List of the expired tasks
+            static constexpr auto TickNone = (std::numeric_limits<std::uint64_t>::max)();
+
+            struct List {
+                Task* m_Head;
+                Task* m_Tail;
+            };
+
+            using Bitmap = std::array<std::uint64_t, Slots / 64>;
+
+            // First occupied slot in [from, Slots), Slots if none
+            [[nodiscard]] static std::uint32_t FindSlot(const Bitmap& bitmap, std::uint32_t from) noexcept
+            {
+                for(auto word = from / 64; word < bitmap.size(); ++word)
+                {
+                    auto bits = bitmap[word];
+                    if(word == from / 64) {
+                        bits &= ~std::uint64_t{} << (from % 64);
+                    }
+
+                    if(bits) {
+                        return word * 64 + static_cast<std::uint32_t>(std::countr_zero(bits));
+                    }
+                }
+
+                return Slots;
+            }
+
+        public:
+            Queue() : m_Lists{}, m_Bitmaps{}, m_Current{}, m_Size{}, m_Wheel{} {}
+            ~Queue() = default;
+            Queue(const Queue&) = delete;
+            Queue(Queue&&) noexcept = default;
+            Queue& operator=(const Queue&) = delete;
+            Queue& operator=(Queue&&) noexcept = default;
+
+            void Insert(Task& task, std::uint64_t timeNow)
+            {
+                // Empty wheel: nothing to cascade, jump to the current time
+                if(!m_Size) {
+                    m_Current = (std::max)(m_Current, timeNow / Resolution);
+                }
+
+                // Round up: the task is never fired before the expiration time
+                task.m_Hook.m_Tick = task.m_Expired / Resolution + (task.m_Expired % Resolution != 0);
+                Place(task);
+                ++m_Size;
+            }
+
+            void Erase(Task& task) noexcept {
+                Unlink(task);
+                --m_Size;
+            }
+
+            void InsertMany(std::span<Task* const> tasks, std::uint64_t timeNow) {
+                for(auto* task : tasks) {
+                    Insert(*task, timeNow);
+                }
+            }
+
+            template <typename Func>
+            void EraseMany(std::span<Task* const> tasks, Func&& fnErased) {
+                for(auto* task : tasks) {
+                    Erase(*task);
+                    fnErased(*task);
+                }
+            }
+
+            //! Insert and Erase are O(1): the batch is never cheaper than the tasks one by one
+            [[nodiscard]] bool IsBulk([[maybe_unused]] std::size_t count) const noexcept {
+                return false;
+            }
+
+            [[nodiscard]] Task* Front(std::uint64_t timeNow) noexcept {
+                Advance(timeNow / Resolution);
+                return m_Lists[Due].m_Head;
+            }
+
+            /**
+            * @brief Returns the time of the next tick with the tasks
+            * @note It can be earlier than the expiration time of the earliest task, never later
+            */
+            [[nodiscard]] std::uint64_t NextTime() const noexcept
+            {
+                if(const auto* task = m_Lists[Due].m_Head) {
+                    return task->m_Expired;
+                }
+
+                const auto tick = NextTick();
+                return tick == TickNone ? TickNone : tick * Resolution;
+            }
+
+            void Clear() noexcept {
+                m_Lists = {};
+                m_Bitmaps = {};
+                m_Size = 0;
+                m_Wheel = 0;
+            }
+
+        private:
+            void Place(Task& task) noexcept
+            {
+                const auto tick = task.m_Hook.m_Tick;
+                if(tick <= m_Current) {
+                    Link(Due, task);
+                    return;
+                }
+
+                const auto delta = tick - m_Current;
+                std::uint32_t level = 0;
+                while(level + 1 < Levels && delta >> (Bits * (level + 1))) {
+                    ++level;
+                }
+
+                // Beyond the last level: park at the farthest slot, the task is placed again by the cascade
+                const auto target = delta >> (Bits * Levels) ? m_Current + (std::uint64_t{1} << (Bits * Levels)) - 1 : tick;
+                const auto slot = static_cast<std::uint32_t>(target >> (Bits * level)) & Mask;
+
+                Link(level * Slots + slot, task);
+                m_Bitmaps[level][slot / 64] |= std::uint64_t{1} << (slot % 64);
+                ++m_Wheel;
+            }
+
+            void Link(std::uint32_t index, Task& task) noexcept
+            {
+                auto& list = m_Lists[index];
+                task.m_Hook.m_List = index;
+                task.m_Hook.m_Prev = list.m_Tail;
+                task.m_Hook.m_Next = nullptr;
+
+                if(list.m_Tail) {
+                    list.m_Tail->m_Hook.m_Next = &task;
+                } else {
+                    list.m_Head = &task;
+                }
+
+                list.m_Tail = &task;
+            }
+
+            void Unlink(Task& task) noexcept
+            {
+                const auto index = task.m_Hook.m_List;
+                auto& list = m_Lists[index];
+
+                if(task.m_Hook.m_Prev) {
+                    task.m_Hook.m_Prev->m_Hook.m_Next = task.m_Hook.m_Next;
+                } else {
+                    list.m_Head = task.m_Hook.m_Next;
+                }
+
+                if(task.m_Hook.m_Next) {
+                    task.m_Hook.m_Next->m_Hook.m_Prev = task.m_Hook.m_Prev;
+                } else {
+                    list.m_Tail = task.m_Hook.m_Prev;
+                }
+
+                task.m_Hook.m_Prev = nullptr;
+                task.m_Hook.m_Next = nullptr;
+
+                if(index != Due) {
+                    --m_Wheel;
+                    if(!list.m_Head) {
+                        const auto slot = index & Mask;
+                        m_Bitmaps[index / Slots][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+                    }
+                }
+            }
+
+            // Earliest tick when a slot has to be collected (level 0) or cascaded (upper levels)
+            [[nodiscard]] std::uint64_t NextTick() const noexcept
+            {
+                if(!m_Wheel) {
+                    return TickNone;
+                }
+
+                auto tick = TickNone;
+                for(std::uint32_t level = 0; level < Levels; ++level)
+                {
+                    const auto block = m_Current >> (Bits * level);
+                    const auto index = static_cast<std::uint32_t>(block) & Mask;
+
+                    auto slot = FindSlot(m_Bitmaps[level], index + 1);
+                    if(slot == Slots) {
+                        slot = FindSlot(m_Bitmaps[level], 0);
+                    }
+
+                    if(slot == Slots) {
+                        continue;
+                    }
+
+                    // The slot of the current block is reached again after the full rotation
+                    const auto distance = ((slot - index) & Mask) ? ((slot - index) & Mask) : Slots;
+                    tick = (std::min)(tick, (block + distance) << (Bits * level));
+                }
+
+                return tick;
+            }
+
+            void Advance(std::uint64_t target) noexcept
+            {
+                while(m_Current < target)
+                {
+                    const auto tick = NextTick();
+                    if(tick > target) {
+                        m_Current = target;
+                        break;
+                    }
+
+                    m_Current = tick;
+                    for(std::uint32_t level = 1; level < Levels && !(m_Current & ((std::uint64_t{1} << (Bits * level)) - 1)); ++level) {
+                        Cascade(level);
+                    }
+
+                    Cascade(0);
+                }
+            }
+
+            // Place the tasks of the current slot again: to the lower levels or to the due list
+            void Cascade(std::uint32_t level) noexcept
+            {
+                const auto slot = static_cast<std::uint32_t>(m_Current >> (Bits * level)) & Mask;
+                auto& list = m_Lists[level * Slots + slot];
+
+                auto* task = list.m_Head;
+                list = {};
+                m_Bitmaps[level][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+
+                while(task) {
+                    auto* next = task->m_Hook.m_Next;
+                    --m_Wheel;
+                    Place(*task);
+                    task = next;
+                }
+            }
+
+        private:
+            std::array<List, Levels * Slots + 1> m_Lists;
+            std::array<Bitmap, Levels> m_Bitmaps;
+            std::uint64_t m_Current;    // Current tick
+            std::size_t m_Size;         // Tasks in the queue
+            std::size_t m_Wheel;        // Tasks in the slots (not in the due list)
+        };
+    };
+}
+
+#endif // HELENA_TYPES_TASKQUEUE_HPP
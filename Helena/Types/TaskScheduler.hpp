@@ -4,227 +4,838 @@
 #include <algorithm>
 #include <chrono>
 #include <concepts>
-#include <functional>
+#include <limits>
 #include <memory>
+#include <optional>
+#include <span>
 #include <type_traits>
 #include <vector>
-#include <unordered_map>
 #include <utility>
 
 #include <Helena/Engine/Log.hpp>
 #include <Helena/Platform/Assert.hpp>
+#include <Helena/Types/Clock.hpp>
+#include <Helena/Types/FlatIndex.hpp>
+#include <Helena/Types/Histogram.hpp>
+#include <Helena/Types/InplaceFunction.hpp>
+#include <Helena/Types/TaskQueue.hpp>
 
 namespace Helena::Types
 {
-    class TaskScheduler final
+    //! Time source of BasicTaskScheduler: Clock::Now
+    struct TaskClockPrecise {
+        [[nodiscard]] static std::uint64_t Now() noexcept {
+            return Clock::Now();
+        }
+    };
+
+    //! Time source of BasicTaskScheduler: Clock::Coarse, enough for the millisecond delays
+    struct TaskClockCoarse {
+        [[nodiscard]] static std::uint64_t Now() noexcept {
+            return Clock::Coarse();
+        }
+    };
+
+    //! Handle of the task returned by BasicTaskScheduler::Create: the slot and the generation of the task
+    struct TaskHandle {
+        std::uint32_t m_Slot {};
+        std::uint32_t m_Generation {};  // Odd while the task is alive
+
+        [[nodiscard]] explicit operator bool() const noexcept {
+            return m_Generation & 1;
+        }
+
+        [[nodiscard]] bool operator==(const TaskHandle&) const noexcept = default;
+    };
+
+    //! Owner of the tasks (e.g. the entity) passed to BasicTaskScheduler::Create, RemoveGroup cancels all tasks of the group
+    struct TaskGroup {
+        std::uint64_t m_Key {};
+
+        [[nodiscard]] bool operator==(const TaskGroup&) const noexcept = default;
+    };
+
+    //! Statistics of BasicTaskScheduler collected since SetStats(true) or ResetStats
+    struct TaskSchedulerStats
+    {
+        std::uint64_t m_Fired;          // Fired tasks
+        std::uint64_t m_Updates;        // Update passes
+        std::uint64_t m_LatenessP50;    // Time from the deadline to the Update pass in nanoseconds
+        std::uint64_t m_LatenessP99;
+        std::uint64_t m_LatenessMax;
+        std::uint64_t m_FiredP50;       // Tasks fired per Update pass
+        std::uint64_t m_FiredP99;
+        std::uint64_t m_FiredMax;
+    };
+
+    /**
+    * @brief Scheduler of the delayed and repeated tasks
+    * @tparam Backend Queue of the tasks ordered by the expiration time: TaskQueueSorted or TaskQueueWheel
+    * @tparam TimeSource Clock of the scheduler: TaskClockPrecise or TaskClockCoarse
+    * @note
+    * Callback signature: void(std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat, Args...),
+    * the callback can change the delay and the remaining repeats of the next call by the references.
+    * The delay is kept in nanoseconds: the std::chrono::duration overloads schedule sub-millisecond deadlines
+    * (TaskQueueSorted is exact, TaskQueueWheel rounds up to its Resolution), the ms of the callback is truncated.
+    * The callback can remove, modify or create the tasks, including itself.
+    * Tasks are kept in the pool of slots with stable addresses, the id is mapped to the slot by FlatIndex:
+    * Create, Remove, Modify and Has don't allocate once the pool and the index reached the peak size
+    * (except the callbacks whose captures and args exceed the small buffer of the Callback).
+    * Create returns the TaskHandle: Remove, Modify and Has by the handle skip the id lookup,
+    * the handle of the removed or finished task is rejected by the generation of the slot.
+    * CreateMany and RemoveMany apply the batch with one queue operation (see TaskQueueSorted::InsertMany).
+    * The task created with the TaskGroup is linked into the intrusive list of the group:
+    * RemoveGroup cancels the k tasks of the group in O(k) queue erases without tracking the ids.
+    * Update reads the clock once per pass: the callbacks, the repeats and the tasks created by the callbacks
+    * use the time of the pass, and they are never fired again in the same pass (even with zero delay).
+    */
+    template <typename Backend, typename TimeSource = TaskClockPrecise>
+    class BasicTaskScheduler final
     {
-        using SteadyClock = std::chrono::steady_clock;
-        using Nano = std::chrono::duration<std::uint64_t, std::nano>;
         using Milli = std::chrono::duration<std::uint64_t, std::milli>;
-        using Callback = std::function<void (std::uint64_t, std::uint64_t&, std::uint32_t&)>;
+
+        struct Stats {
+            Histogram<> m_Lateness;
+            Histogram<> m_Fired;
+        };
+
+    public:
+        //! Type-erased callback of the task, passed to Create as is (without the wrapper)
+        using Callback = InplaceFunction<void (std::uint64_t, std::uint64_t&, std::uint32_t&), 64>;
+
+        //! Task of CreateMany, the callback is moved into the scheduler
+        struct Descriptor {
+            std::uint64_t m_Id {};
+            std::chrono::nanoseconds m_Delay {};
+            std::uint32_t m_Repeat {1};
+            Callback m_Callback {};
+            std::optional<TaskGroup> m_Group {};
+        };
 
     private:
+        static constexpr std::uint32_t ChunkSize = 512;     // Slots per chunk of the pool
+
         struct Task {
-            Task(std::uint64_t id, std::uint64_t time, std::uint64_t expired, std::uint32_t repeat, Callback cb)
-                : m_Id{id}, m_Time{time}, m_Expired{expired}, m_Repeat{repeat}, m_Callback{std::move(cb)} {}
+            Task() = default;
             ~Task() = default;
             Task(const Task&) = delete;
-            Task(Task&&) noexcept = default;
+            Task(Task&&) noexcept = delete;
             Task& operator=(const Task&) = delete;
-            Task& operator=(Task&&) noexcept = default;
-
-            std::uint64_t m_Id;
-            std::uint64_t m_Time;
-            std::uint64_t m_Expired;
-            std::uint32_t m_Repeat;
-            Callback m_Callback;
+            Task& operator=(Task&&) noexcept = delete;
+
+            std::uint64_t m_Id {};
+            std::uint64_t m_Group {};       // Key of the group if m_Grouped
+            std::uint64_t m_Delay {};       // Nanoseconds
+            std::uint64_t m_Expired {};
+            std::uint32_t m_Repeat {};
+            std::uint32_t m_Generation {};  // Incremented on create and remove: odd while the task is alive
+            std::uint32_t m_Slot {};
+            std::uint32_t m_GroupPrev {};   // Slots of the neighbours in the list of the group, FlatIndex::None at the ends
+            std::uint32_t m_GroupNext {};
+            bool m_Grouped {};
+            Callback m_Callback {};
+            [[no_unique_address]] typename Backend::template Hook<Task> m_Hook {};
         };
 
-        struct Time {
-            Time(std::uint64_t time, Task* task) : m_Time{time}, m_Task{task} {}
-            ~Time() = default;
-            Time(const Time&) = default;
-            Time(Time&&) noexcept = default;
-            Time& operator=(const Time&) = default;
-            Time& operator=(Time&&) noexcept = default;
-
-            std::uint64_t m_Time;
-            Task* m_Task;
-        };
+        // Chunks are never moved or released: the addresses are stable for the intrusive queues
+        using Chunks = std::vector<std::unique_ptr<Task[]>>;
+        using Queue = typename Backend::template Queue<Task>;
 
     public:
-        TaskScheduler() = default;
-        ~TaskScheduler() = default;
-        TaskScheduler(const TaskScheduler&) = delete;
-        TaskScheduler(TaskScheduler&&) noexcept = default;
-        TaskScheduler& operator=(const TaskScheduler&) = delete;
-        TaskScheduler& operator=(TaskScheduler&&) noexcept = default;
+        BasicTaskScheduler() = default;
+        ~BasicTaskScheduler() = default;
+        BasicTaskScheduler(const BasicTaskScheduler&) = delete;
+        BasicTaskScheduler(BasicTaskScheduler&&) noexcept = default;
+        BasicTaskScheduler& operator=(const BasicTaskScheduler&) = delete;
+        BasicTaskScheduler& operator=(BasicTaskScheduler&&) noexcept = default;
+
+        template <typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        TaskHandle Create(std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, Func&& cb, Args&&... args) {
+            return Create(id, Milli{ms}, repeat, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
 
         template <typename Func, typename... Args>
         requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
-        void Create(std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, Func&& cb, Args&&... args)
+        TaskHandle Create(std::uint64_t id, std::uint64_t ms, Func&& cb, Args&&... args) {
+            return Create(id, Milli{ms}, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
+
+        template <typename Rep, typename Period, typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        TaskHandle Create(std::uint64_t id, std::chrono::duration<Rep, Period> delay, Func&& cb, Args&&... args) {
+            return Create(id, delay, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
+
+        /**
+        * @brief Create the task
+        * @param id Id of the task
+        * @param delay Delay of the calls (std::chrono::microseconds, milliseconds, etc.)
+        * @param repeat Number of the calls
+        * @param cb Callback
+        * @param args Arguments passed to the callback
+        * @return Handle of the task, invalid if the task is not created
+        */
+        template <typename Rep, typename Period, typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        TaskHandle Create(std::uint64_t id, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat, Func&& cb, Args&&... args)
         {
-            HELENA_ASSERT(repeat, "Repeat is null");
-            if(!repeat) {
-                HELENA_MSG_ERROR("TaskID: {} not created, repeat is null!", id);
-                return;
+            const auto timeNow = TimeNow();
+            auto* task = EmplaceTask(id, ToNano(delay), repeat, timeNow);
+            if(!task) {
+                return TaskHandle{};
             }
 
-            const auto expired = TimeNow() + TimeNano(ms);
-            const auto [it, result] = m_Tasks.try_emplace(id, id, ms, expired, repeat,
-                [cb = std::forward<decltype(cb)>(cb), ...args = std::forward<Args>(args)]
-                (std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat) mutable {
-                    std::forward<decltype(cb)>(cb)(id, ms, repeat, std::forward<Args>(args)...);
-            });
+            if constexpr(!sizeof...(Args) && std::is_same_v<std::decay_t<Func>, Callback>) {
+                task->m_Callback = std::forward<Func>(cb);
+            } else {
+                task->m_Callback = [cb = std::forward<decltype(cb)>(cb), ...args = std::forward<Args>(args)]
+                    (std::uint64_t id, std::uint64_t& ms, std::uint32_t& repeat) mutable {
+                        std::forward<decltype(cb)>(cb)(id, ms, repeat, std::forward<Args>(args)...);
+                };
+            }
 
-            HELENA_ASSERT(result);
-            if(!result) {
-                HELENA_MSG_ERROR("TaskID: {} already exist!", id);
-                return;
+            m_Queue.Insert(*task, timeNow);
+            return TaskHandle{task->m_Slot, task->m_Generation};
+        }
+
+        /**
+        * @brief Create the task of the group
+        * @param group Group of the task, see RemoveGroup
+        * @param id Id of the task
+        * @param delay Delay of the calls (std::chrono::microseconds, milliseconds, etc.)
+        * @param repeat Number of the calls
+        * @param cb Callback
+        * @param args Arguments passed to the callback
+        * @return Handle of the task, invalid if the task is not created
+        */
+        template <typename Rep, typename Period, typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        TaskHandle Create(TaskGroup group, std::uint64_t id, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat, Func&& cb, Args&&... args)
+        {
+            const auto handle = Create(id, delay, repeat, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+            if(handle) {
+                JoinGroup(GetTask(handle.m_Slot), group);
             }
 
-            m_Times.emplace(Find(expired), expired, std::addressof(it->second));
+            return handle;
         }
 
-        [[nodiscard]] bool Has(std::uint64_t id) const noexcept {
-            return m_Tasks.contains(id);
+        template <typename Rep, typename Period, typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        TaskHandle Create(TaskGroup group, std::uint64_t id, std::chrono::duration<Rep, Period> delay, Func&& cb, Args&&... args) {
+            return Create(group, id, delay, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
         }
 
         template <typename Func, typename... Args>
         requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
-        void Create(std::uint64_t id, std::uint64_t ms, Func&& cb, Args&&... args) {
-            return Create(id, ms, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        TaskHandle Create(TaskGroup group, std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, Func&& cb, Args&&... args) {
+            return Create(group, id, Milli{ms}, repeat, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
         }
 
-        void Modify(std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, bool update)
+        template <typename Func, typename... Args>
+        requires std::invocable<Func, std::uint64_t, std::uint64_t&, std::uint32_t&, Args...>
+        TaskHandle Create(TaskGroup group, std::uint64_t id, std::uint64_t ms, Func&& cb, Args&&... args) {
+            return Create(group, id, Milli{ms}, 1u, std::forward<decltype(cb)>(cb), std::forward<Args>(args)...);
+        }
+
+        /**
+        * @brief Create the batch of tasks
+        * @param tasks Tasks, the callbacks are moved from the descriptors
+        * @param handles Handles of the created tasks in the order of the descriptors (optional)
+        * @return Number of the created tasks
+        * @note The tasks with the duplicate id or the null repeat are skipped (invalid handle)
+        */
+        std::size_t CreateMany(std::span<Descriptor> tasks, std::span<TaskHandle> handles = {})
         {
-            HELENA_ASSERT(repeat);
-            if(const auto it = m_Tasks.find(id); it != m_Tasks.cend())
-            {
-                auto& task = it->second;
-                task.m_Repeat = (std::max)(1u, repeat);
-                task.m_Time = ms;
-
-                if(update) {
-                    const auto timeNew = TimeNow() + TimeNano(ms);
-                    const auto itr = Find(task.m_Expired, id);
-                    HELENA_ASSERT(itr != m_Times.end());
-                    // Erase and emplace only when m_Time != expiredNow
-                    if(itr != m_Times.end() && itr->m_Time != timeNew) {
-                        m_Times.erase(itr);
-                        m_Times.emplace(Find(timeNew), timeNew, std::addressof(task));
+            return CreateBatch(tasks.size(), handles, [this, tasks](std::size_t index, std::uint64_t timeNow) {
+                auto& descriptor = tasks[index];
+                auto* task = EmplaceTask(descriptor.m_Id, ToNano(descriptor.m_Delay), descriptor.m_Repeat, timeNow);
+                if(task) {
+                    task->m_Callback = std::move(descriptor.m_Callback);
+                    if(descriptor.m_Group) {
+                        JoinGroup(*task, *descriptor.m_Group);
                     }
                 }
+
+                return task;
+            });
+        }
+
+        /**
+        * @brief Create the tasks of the ids with the same delay and the copy of the callback
+        * @param ids Ids of the tasks
+        * @param delay Delay of the calls (std::chrono::microseconds, milliseconds, etc.)
+        * @param repeat Number of the calls
+        * @param cb Callback, copied into each task
+        * @param handles Handles of the created tasks in the order of the ids (optional)
+        * @return Number of the created tasks
+        */
+        template <typename Rep, typename Period, typename Func>
+        requires std::invocable<Func&, std::uint64_t, std::uint64_t&, std::uint32_t&> && std::copy_constructible<std::decay_t<Func>>
+        std::size_t CreateMany(std::span<const std::uint64_t> ids, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat,
+            const Func& cb, std::span<TaskHandle> handles = {})
+        {
+            const auto nano = ToNano(delay);
+            return CreateBatch(ids.size(), handles, [this, ids, nano, repeat, &cb](std::size_t index, std::uint64_t timeNow) {
+                auto* task = EmplaceTask(ids[index], nano, repeat, timeNow);
+                if(task) {
+                    task->m_Callback = cb;
+                }
+
+                return task;
+            });
+        }
+
+        template <typename Func>
+        requires std::invocable<Func&, std::uint64_t, std::uint64_t&, std::uint32_t&> && std::copy_constructible<std::decay_t<Func>>
+        std::size_t CreateMany(std::span<const std::uint64_t> ids, std::uint64_t ms, std::uint32_t repeat,
+            const Func& cb, std::span<TaskHandle> handles = {}) {
+            return CreateMany(ids, Milli{ms}, repeat, cb, handles);
+        }
+
+        [[nodiscard]] bool Has(std::uint64_t id) const noexcept {
+            return m_Index.Contains(id);
+        }
+
+        [[nodiscard]] bool Has(TaskHandle handle) const noexcept {
+            return Find(handle);
+        }
+
+        void Modify(std::uint64_t id, std::uint64_t ms, std::uint32_t repeat, bool update) {
+            Modify(id, Milli{ms}, repeat, update);
+        }
+
+        void Modify(TaskHandle handle, std::uint64_t ms, std::uint32_t repeat, bool update) {
+            Modify(handle, Milli{ms}, repeat, update);
+        }
+
+        template <typename Rep, typename Period>
+        void Modify(std::uint64_t id, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat, bool update)
+        {
+            HELENA_ASSERT(repeat);
+            if(const auto slot = m_Index.Find(id); slot != FlatIndex::None) {
+                ModifyTask(GetTask(slot), ToNano(delay), repeat, update);
+            }
+        }
+
+        template <typename Rep, typename Period>
+        void Modify(TaskHandle handle, std::chrono::duration<Rep, Period> delay, std::uint32_t repeat, bool update)
+        {
+            HELENA_ASSERT(repeat);
+            if(auto* task = Find(handle)) {
+                ModifyTask(*task, ToNano(delay), repeat, update);
             }
         }
 
         void Remove(std::uint64_t id)
         {
-            if(const auto it = m_Tasks.find(id); it != m_Tasks.cend())
+            if(const auto slot = m_Index.Find(id); slot != FlatIndex::None) {
+                RemoveTask(GetTask(slot));
+            }
+        }
+
+        void Remove(TaskHandle handle)
+        {
+            if(auto* task = Find(handle)) {
+                RemoveTask(*task);
+            }
+        }
+
+        /**
+        * @brief Remove the tasks of the ids
+        * @return Number of the removed tasks
+        */
+        std::size_t RemoveMany(std::span<const std::uint64_t> ids)
+        {
+            return RemoveBatch(ids.size(), [this, ids](std::size_t index) -> Task* {
+                const auto slot = m_Index.Find(ids[index]);
+                return slot != FlatIndex::None ? &GetTask(slot) : nullptr;
+            });
+        }
+
+        /**
+        * @brief Remove the tasks of the handles
+        * @return Number of the removed tasks
+        */
+        std::size_t RemoveMany(std::span<const TaskHandle> handles)
+        {
+            return RemoveBatch(handles.size(), [this, handles](std::size_t index) {
+                return Find(handles[index]);
+            });
+        }
+
+        /**
+        * @brief Remove all tasks of the group
+        * @param group Group passed to Create
+        * @return Number of the removed tasks
+        * @note The tasks created by the destructors of the removed callbacks are kept
+        */
+        std::size_t RemoveGroup(TaskGroup group)
+        {
+            auto slot = m_Groups.Find(group.m_Key);
+            if(slot == FlatIndex::None) {
+                return 0;
+            }
+
+            // Detach the whole list: the removed tasks don't relink the neighbours one by one
+            m_Groups.Erase(group.m_Key);
+
+            auto batch = std::move(m_Batch);
+            batch.clear();
+
+            std::size_t removed{};
+            while(slot != FlatIndex::None)
             {
-                const auto itr = Find(it->second.m_Expired, id);
-                HELENA_ASSERT(itr != m_Times.end(), "WTF? Why not found?");
-                if(itr != m_Times.end()) {
-                    m_Times.erase(itr);
+                auto& task = GetTask(slot);
+                slot = task.m_GroupNext;
+                task.m_Grouped = false;
+
+                if(DetachTask(task)) {
+                    batch.push_back(&task);
                 }
-                m_Tasks.erase(it);
+
+                ++removed;
             }
+
+            ReleaseBatch(batch);
+            return removed;
+        }
+
+        [[nodiscard]] bool HasGroup(TaskGroup group) const noexcept {
+            return m_Groups.Contains(group.m_Key);
         }
 
         [[nodiscard]] std::size_t Count() const noexcept {
-            return m_Tasks.size();
+            return m_Index.Size();
+        }
+
+        /**
+        * @brief Reserve the slots and the index for the tasks
+        * @param count Number of tasks
+        */
+        void Reserve(std::size_t count)
+        {
+            m_Index.Reserve(count);
+            while(m_Chunks.size() * ChunkSize < count) {
+                AddChunk();
+            }
         }
 
-        void Clear() {
-            m_Tasks.clear();
-            m_Times.clear();
+        /**
+        * @brief Returns the expiration time of the earliest task
+        * @return Time in nanoseconds of the TimeSource or max if the scheduler is empty
+        * @note
+        * Can be passed to Engine::WakeupAt for wake up the engine in time,
+        * TaskQueueWheel returns the time of the wheel tick (not later than the expiration time)
+        */
+        [[nodiscard]] std::uint64_t NextTime() const noexcept {
+            return m_Queue.NextTime();
         }
 
-        void Update()
+        void Clear()
         {
-            while(!m_Times.empty())
+            m_Index.Clear();
+            m_Groups.Clear();
+            m_Queue.Clear();
+            m_Free.clear();
+
+            // Reversed: the lower slots are reused first
+            for(auto slot = static_cast<std::uint32_t>(m_Chunks.size() * ChunkSize); slot--;)
             {
-                const auto timeNow = TimeNow();
-                const auto timeTask = m_Times.back();
+                auto& task = GetTask(slot);
+                task.m_Generation += task.m_Generation & 1;
+                task.m_Grouped = false;
+
+                // The running task is released by Update after the callback
+                if(&task != m_Running) {
+                    task.m_Callback = nullptr;
+                    m_Free.push_back(slot);
+                }
+            }
+        }
+
+        /**
+        * @brief Enable or disable the statistics
+        * @note The histograms (~16 KiB) are allocated on enable, disabled statistics cost one branch per task
+        */
+        void SetStats(bool enable)
+        {
+            if(!enable) {
+                m_Stats.reset();
+            } else if(!m_Stats) {
+                m_Stats = std::make_unique<Stats>();
+            }
+        }
+
+        void ResetStats() noexcept
+        {
+            if(m_Stats) {
+                m_Stats->m_Lateness.Reset();
+                m_Stats->m_Fired.Reset();
+            }
+        }
+
+        /**
+        * @brief Returns the statistics, zeros if disabled
+        * @note Lateness is measured at the time of the Update pass: use it to choose the tickrate
+        */
+        [[nodiscard]] TaskSchedulerStats GetStats() const noexcept
+        {
+            if(!m_Stats) {
+                return TaskSchedulerStats{};
+            }
+
+            const auto& [lateness, fired] = *m_Stats;
+            return TaskSchedulerStats{
+                .m_Fired = lateness.Count(),
+                .m_Updates = fired.Count(),
+                .m_LatenessP50 = lateness.Percentile(50.0),
+                .m_LatenessP99 = lateness.Percentile(99.0),
+                .m_LatenessMax = lateness.Max(),
+                .m_FiredP50 = fired.Percentile(50.0),
+                .m_FiredP99 = fired.Percentile(99.0),
+                .m_FiredMax = fired.Max()
+            };
+        }
+
+        void Update() {
+            Update(TimeSource::Now());
+        }
+
+        /**
+        * @brief Fire the tasks expired at the time
+        * @param timeNow Time in nanoseconds of the TimeSource, e.g. the time of the frame already read by the caller
+        */
+        void Update(std::uint64_t timeNow)
+        {
+            HELENA_ASSERT(!m_Updating, "Update called from the callback");
+
+            m_Updating = true;
+            m_TimeUpdate = timeNow;
+            std::uint64_t fired{};
 
-                // Check time and exit from loop
-                if(timeTask.m_Time > timeNow) {
-                    break;
+            while(auto* task = m_Queue.Front(timeNow))
+            {
+                HELENA_ASSERT(task->m_Repeat, "Repeat is null");
+                m_Queue.Erase(*task);
+                ++fired;
+
+                if(m_Stats) {
+                    m_Stats->m_Lateness.Record(timeNow - (std::min)(timeNow, task->m_Expired));
                 }
 
-                auto* task = timeTask.m_Task;
-                const auto id = task->m_Id;
-                const auto addressOld = reinterpret_cast<std::uintptr_t>(std::addressof(*task));
-                HELENA_ASSERT(task->m_Repeat, "WTF? Repeat is null");
-                task->m_Callback(id, task->m_Time, --task->m_Repeat);
+                const auto generation = task->m_Generation;
+                const auto msDelay = task->m_Delay / 1'000'000;
+                auto ms = msDelay;
 
-                // TODO: Optimization if task modificated
+                m_Running = task;
+                task->m_Callback(task->m_Id, ms, --task->m_Repeat);
+                m_Running = nullptr;
 
-                // If task not found in m_Times then continue
-                // because task removed from callback
-                const auto it = Find(timeTask.m_Time, id);
-                if(it == m_Times.end()) {
+                // Removed by the callback: the id can be already used by a new task in the other slot
+                if(task->m_Generation != generation) {
+                    task->m_Callback = nullptr;
+                    m_Free.push_back(task->m_Slot);
                     continue;
                 }
 
-                task = it->m_Task;
-                HELENA_ASSERT(task, "WTF? Task is null");
-                if(task->m_Repeat)
-                {
-                    // Compare old task address and new
-                    // if time not changed, but task recreated we should ignore emplace
-                    const auto addressNew = reinterpret_cast<std::uintptr_t>(std::addressof(*task));
-                    if(addressOld == addressNew) {
-                        task->m_Expired = timeNow + TimeNano(task->m_Time);
-                        m_Times.erase(it);
-                        m_Times.emplace(Find(task->m_Expired), task->m_Expired, std::addressof(*task));
-                    }
+                // Sub-millisecond delay is kept unless the callback changed the ms
+                if(ms != msDelay) {
+                    task->m_Delay = ToNano(Milli{ms});
+                }
+
+                if(task->m_Repeat) {
+                    task->m_Expired = Expiration(timeNow, task->m_Delay);
+                    m_Queue.Insert(*task, timeNow);
                     continue;
                 }
 
-                m_Times.erase(it);
-                m_Tasks.erase(task->m_Id);
+                m_Index.Erase(task->m_Id);
+                Release(*task);
+            }
+
+            if(m_Stats) {
+                m_Stats->m_Fired.Record(fired);
             }
+
+            m_Updating = false;
         }
 
     private:
-        [[nodiscard]] auto Find(std::uint64_t time) -> std::vector<Time>::iterator {
-            const auto it = std::lower_bound(m_Times.rbegin(), m_Times.rend(), time, [](const auto& time, const auto expired) {
-                return time.m_Time < expired;
-            });
-            return it == m_Times.rend() ? m_Times.begin() : it.base();
+        [[nodiscard]] Task& GetTask(std::uint32_t slot) const noexcept {
+            return m_Chunks[slot / ChunkSize][slot % ChunkSize];
         }
 
-        [[nodiscard]] auto Find(std::uint64_t time, std::uint64_t id) -> std::vector<Time>::iterator
+        [[nodiscard]] Task* Find(TaskHandle handle) const noexcept
         {
-            const auto it = Find(time);
-            for(std::size_t size = std::distance(m_Times.begin(), it); size; --size)
+            if(!handle || handle.m_Slot >= m_Chunks.size() * ChunkSize) {
+                return nullptr;
+            }
+
+            auto& task = GetTask(handle.m_Slot);
+            return task.m_Generation == handle.m_Generation ? &task : nullptr;
+        }
+
+        // Acquire the slot of the new task, the task is not in the queue yet
+        [[nodiscard]] Task* EmplaceTask(std::uint64_t id, std::uint64_t delay, std::uint32_t repeat, std::uint64_t timeNow)
+        {
+            HELENA_ASSERT(repeat, "Repeat is null");
+            if(!repeat) {
+                HELENA_MSG_ERROR("TaskID: {} not created, repeat is null!", id);
+                return nullptr;
+            }
+
+            const auto slot = Acquire();
+            const auto result = m_Index.Insert(id, slot);
+            HELENA_ASSERT(result);
+            if(!result) {
+                m_Free.push_back(slot);
+                HELENA_MSG_ERROR("TaskID: {} already exist!", id);
+                return nullptr;
+            }
+
+            auto& task = GetTask(slot);
+            ++task.m_Generation;
+            task.m_Id = id;
+            task.m_Delay = delay;
+            task.m_Expired = Expiration(timeNow, delay);
+            task.m_Repeat = repeat;
+            return &task;
+        }
+
+        template <typename Func>
+        std::size_t CreateBatch(std::size_t count, std::span<TaskHandle> handles, Func&& fnEmplace)
+        {
+            // Taken out of the member: the callbacks destroyed by the nested calls can't touch it
+            auto batch = std::move(m_Batch);
+            batch.clear();
+            batch.reserve(count);
+            Reserve(Count() + count);
+
+            const auto timeNow = TimeNow();
+            for(std::size_t index = 0; index < count; ++index)
+            {
+                auto* task = fnEmplace(index, timeNow);
+                if(index < handles.size()) {
+                    handles[index] = task ? TaskHandle{task->m_Slot, task->m_Generation} : TaskHandle{};
+                }
+
+                if(task) {
+                    batch.push_back(task);
+                }
+            }
+
+            m_Queue.InsertMany(batch, timeNow);
+
+            const auto created = batch.size();
+            m_Batch = std::move(batch);
+            return created;
+        }
+
+        template <typename Func>
+        std::size_t RemoveBatch(std::size_t count, Func&& fnFind)
+        {
+            std::size_t removed{};
+
+            // One pass over the tasks: the queue gains nothing from the batch
+            if(!m_Queue.IsBulk(count)) {
+                for(std::size_t index = 0; index < count; ++index) {
+                    if(auto* task = fnFind(index)) {
+                        RemoveTask(*task);
+                        ++removed;
+                    }
+                }
+
+                return removed;
+            }
+
+            auto batch = std::move(m_Batch);
+            batch.clear();
+
+            for(std::size_t index = 0; index < count; ++index)
             {
-                const auto& value = m_Times[size - 1];
-                if(value.m_Time != time) {
-                    break;
+                // The generation rejects the duplicates of the batch
+                if(auto* task = fnFind(index)) {
+                    if(DetachTask(*task)) {
+                        batch.push_back(task);
+                    }
+
+                    ++removed;
                 }
+            }
+
+            ReleaseBatch(batch);
+            return removed;
+        }
+
+        // Remove the task from the index and the group, the handles are rejected after it.
+        // False for the running task: it is not in the queue, its slot is released by Update
+        [[nodiscard]] bool DetachTask(Task& task) noexcept
+        {
+            m_Index.Erase(task.m_Id);
+            LeaveGroup(task);
+            ++task.m_Generation;
+            return &task != m_Running;
+        }
+
+        // Erase the detached tasks from the queue and release the slots
+        void ReleaseBatch(std::vector<Task*>& batch)
+        {
+            // The callbacks are destroyed when the queue is consistent: they can call the scheduler,
+            // the detached tasks are not reachable by the ids, the handles and the groups
+            m_Queue.EraseMany(batch, [this](Task& task) {
+                task.m_Callback = nullptr;
+                m_Free.push_back(task.m_Slot);
+            });
+
+            batch.clear();
+            if(m_Batch.capacity() < batch.capacity()) {
+                m_Batch = std::move(batch);
+            }
+        }
+
+        void ModifyTask(Task& task, std::uint64_t delay, std::uint32_t repeat, bool update)
+        {
+            task.m_Repeat = (std::max)(1u, repeat);
+            task.m_Delay = delay;
 
-                if(value.m_Task->m_Id == id) {
-                    return m_Times.begin() + (size - 1);
+            // The running task is not in the queue, Update inserts it with the new delay
+            if(update && &task != m_Running) {
+                const auto timeNow = TimeNow();
+                const auto timeNew = Expiration(timeNow, delay);
+                if(task.m_Expired != timeNew) {
+                    m_Queue.Erase(task);
+                    task.m_Expired = timeNew;
+                    m_Queue.Insert(task, timeNow);
                 }
             }
+        }
+
+        void RemoveTask(Task& task)
+        {
+            m_Index.Erase(task.m_Id);
 
-            return m_Times.end();
+            // The running task is not in the queue
+            if(&task != m_Running) {
+                m_Queue.Erase(task);
+            }
+
+            Release(task);
         }
 
-        [[nodiscard]] static std::uint64_t TimeNow() noexcept {
-            return std::chrono::duration_cast<Nano>(SteadyClock::now().time_since_epoch()).count();
+        // Link the task at the head of the list of the group
+        void JoinGroup(Task& task, TaskGroup group)
+        {
+            const auto head = m_Groups.Find(group.m_Key);
+            task.m_Group = group.m_Key;
+            task.m_GroupPrev = FlatIndex::None;
+            task.m_GroupNext = head;
+            task.m_Grouped = true;
+
+            if(head == FlatIndex::None) {
+                m_Groups.Insert(group.m_Key, task.m_Slot);
+            } else {
+                GetTask(head).m_GroupPrev = task.m_Slot;
+                m_Groups.Assign(group.m_Key, task.m_Slot);
+            }
         }
 
-        [[nodiscard]] static std::uint64_t TimeNano(std::uint64_t ms) noexcept {
-            return std::chrono::duration_cast<Nano>(Milli{ms}).count();
+        void LeaveGroup(Task& task) noexcept
+        {
+            if(!task.m_Grouped) {
+                return;
+            }
+
+            task.m_Grouped = false;
+            if(task.m_GroupPrev != FlatIndex::None) {
+                GetTask(task.m_GroupPrev).m_GroupNext = task.m_GroupNext;
+            } else if(task.m_GroupNext != FlatIndex::None) {
+                m_Groups.Assign(task.m_Group, task.m_GroupNext);
+            } else {
+                m_Groups.Erase(task.m_Group);
+            }
+
+            if(task.m_GroupNext != FlatIndex::None) {
+                GetTask(task.m_GroupNext).m_GroupPrev = task.m_GroupPrev;
+            }
+        }
+
+        void AddChunk()
+        {
+            HELENA_ASSERT(m_Chunks.size() * ChunkSize < FlatIndex::None - ChunkSize, "Too many tasks");
+
+            const auto first = static_cast<std::uint32_t>(m_Chunks.size() * ChunkSize);
+            m_Chunks.emplace_back(std::make_unique<Task[]>(ChunkSize));
+            m_Free.reserve(m_Chunks.size() * ChunkSize);
+
+            for(auto slot = first + ChunkSize; slot-- > first;) {
+                GetTask(slot).m_Slot = slot;
+                m_Free.push_back(slot);
+            }
+        }
+
+        [[nodiscard]] std::uint32_t Acquire()
+        {
+            if(m_Free.empty()) {
+                AddChunk();
+            }
+
+            const auto slot = m_Free.back();
+            m_Free.pop_back();
+            return slot;
+        }
+
+        // The slot of the running task is released by Update after the callback
+        void Release(Task& task) noexcept
+        {
+            LeaveGroup(task);
+            ++task.m_Generation;
+
+            if(&task != m_Running) {
+                task.m_Callback = nullptr;
+                m_Free.push_back(task.m_Slot);
+            }
+        }
+
+        [[nodiscard]] std::uint64_t TimeNow() const noexcept {
+            return m_Updating ? m_TimeUpdate : TimeSource::Now();
+        }
+
+        // Tasks scheduled by the callbacks expire after the time of the pass: Update doesn't fire them again
+        [[nodiscard]] std::uint64_t Expiration(std::uint64_t timeNow, std::uint64_t delay) const noexcept {
+            const auto time = timeNow + delay;
+            return m_Updating ? (std::max)(time, m_TimeUpdate + 1) : time;
+        }
+
+        // Rounded up: the task is never fired before the delay, negative delays are null
+        template <typename Rep, typename Period>
+        [[nodiscard]] static std::uint64_t ToNano(std::chrono::duration<Rep, Period> delay) noexcept {
+            const auto nano = std::chrono::ceil<std::chrono::nanoseconds>(delay).count();
+            return nano > 0 ? static_cast<std::uint64_t>(nano) : 0;
         }
 
     private:
-        std::unordered_map<std::uint64_t, Task> m_Tasks;
-        std::vector<Time> m_Times;
+        Chunks m_Chunks;
+        std::vector<std::uint32_t> m_Free;      // Free slots, the last one is reused first
+        FlatIndex m_Index;                      // Id to slot
+        FlatIndex m_Groups;                     // Group key to the slot of the head task of the group
+        Queue m_Queue;
+        std::unique_ptr<Stats> m_Stats;         // Enabled by SetStats
+        std::vector<Task*> m_Batch;             // Tasks of CreateMany, RemoveMany and RemoveGroup, kept for the capacity
+        Task* m_Running {};                     // Task of the callback in progress
+        std::uint64_t m_TimeUpdate {};          // Time of the Update pass in progress
+        bool m_Updating {};
     };
+
+    //! Tasks are fired exactly in the order of the expiration time
+    using TaskScheduler = BasicTaskScheduler<TaskQueueSorted>;
+
+    //! O(1) insert and remove for the large number of tasks, 1 ms resolution
+    using TaskSchedulerWheel = BasicTaskScheduler<TaskQueueWheel<>>;
+
+    //! Timing wheel with the coarse clock: the delays can be shorter by the clock resolution (1-4 ms on Linux)
+    using TaskSchedulerCoarse = BasicTaskScheduler<TaskQueueWheel<>, TaskClockCoarse>;
 }
 
-#endif // HELENA_TYPES_TASKSCHEDULER_HPP
\ No newline at end of file
+#endif // HELENA_TYPES_TASKSCHEDULER_HPP
@@ -0,0 +1,331 @@
+#ifndef HELENA_TYPES_VECTORARENA_HPP
+#define HELENA_TYPES_VECTORARENA_HPP
+
+#include <Helena/Platform/Assert.hpp>
+#include <Helena/Traits/Arguments.hpp>
+#include <Helena/Traits/Cacheline.hpp>
+#include <Helena/Traits/NameOf.hpp>
+#include <Helena/Traits/Remove.hpp>
+#include <Helena/Traits/SameAS.hpp>
+#include <Helena/Types/Hash.hpp>
+#include <Helena/Types/UniqueIndexer.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Helena::Types
+{
+    /**
+    * @brief Container of unique types (one object per type) allocated in the arena
+    * @tparam UniqueKey Key of the type indexer
+    * @tparam ChunkSize Size of the arena chunk in bytes
+    * @note
+    * Objects are placed one after another in the cacheline-aligned chunks: every object starts on its own cacheline,
+    * the objects used together in the frame share the cache and the TLB pages instead of being scattered over the heap.
+    * Chunks are never moved or released before the destruction, the addresses of objects are stable.
+    * The memory of removed objects is reused by the next objects of a suitable size.
+    * The API is the same as for VectorAny.
+    */
+    template <typename UniqueKey, std::size_t ChunkSize = 64 * 1024>
+    class VectorArena final
+    {
+        static_assert(ChunkSize >= Traits::Cacheline, "ChunkSize is too small");
+
+        static constexpr auto Alignment = std::align_val_t{Traits::Cacheline};
+
+        struct ChunkDeleter {
+            void operator()(std::byte* data) const noexcept {
+                ::operator delete(data, Alignment);
+            }
+        };
+
+        struct Chunk {
+            std::unique_ptr<std::byte, ChunkDeleter> m_Data;
+            std::size_t m_Size;
+            std::size_t m_Offset;
+        };
+
+        struct Block {
+            std::byte* m_Data;
+            std::size_t m_Size;
+        };
+
+        struct Entry {
+            using Destroy = void (*)(void*) noexcept;
+
+            void* m_Instance;
+            Destroy m_Destroy;
+            Block m_Block;
+        #if defined(HELENA_DEBUG)
+            std::uint64_t m_Key;
+        #endif
+        };
+
+        [[nodiscard]] static constexpr std::size_t AlignUp(std::size_t value, std::size_t align) noexcept {
+            return (value + align - 1) & ~(align - 1);
+        }
+
+        template <typename T>
+        static void DestroyObject(void* instance) noexcept {
+            std::destroy_at(static_cast<T*>(instance));
+        }
+
+    public:
+        VectorArena() : m_TypeIndexer{}, m_Entries{}, m_Chunks{}, m_Free{} {}
+        ~VectorArena() {
+            Clear();
+        }
+
+        VectorArena(const VectorArena&) = delete;
+        VectorArena(VectorArena&&) noexcept = delete;
+        VectorArena& operator=(const VectorArena&) = delete;
+        VectorArena& operator=(VectorArena&&) noexcept = delete;
+
+        /**
+        * @brief Allocate the chunk for the objects created later
+        * @param size Size in bytes
+        * @note Use it at startup to keep all objects in one contiguous chunk
+        */
+        void Reserve(std::size_t size)
+        {
+            const auto available = std::any_of(m_Chunks.cbegin(), m_Chunks.cend(), [size](const auto& chunk) {
+                return chunk.m_Size - chunk.m_Offset >= size;
+            });
+
+            if(!available) {
+                AddChunk(size);
+            }
+        }
+
+        template <typename T, typename... Args>
+        void Create(Args&&... args)
+        {
+            static_assert(Traits::SameAS<T, Traits::RemoveCVRP<T>>, "Type is const/ptr/ref");
+
+            const auto index = m_TypeIndexer.template Get<T>();
+            HELENA_ASSERT(index >= m_Entries.size() || !m_Entries[index].m_Instance, "Type: {} already exist!", Traits::NameOf<T>{});
+
+            // Same as VectorAny: the existing object is replaced
+            if(index < m_Entries.size() && m_Entries[index].m_Instance) {
+                Destroy(m_Entries[index]);
+            }
+
+            const auto block = Allocate(AlignUp(sizeof(T), Traits::Cacheline), (std::max)(alignof(T), Traits::Cacheline));
+
+            // The constructor can create other objects: the entries are resized after the construction
+            T* instance{};
+            try {
+                if constexpr(std::is_aggregate_v<T>) {
+                    instance = new (block.m_Data) T{std::forward<Args>(args)...};
+                } else {
+                    instance = new (block.m_Data) T(std::forward<Args>(args)...);
+                }
+            } catch(...) {
+                m_Free.emplace_back(block);
+                throw;
+            }
+
+            if(index >= m_Entries.size()) {
+                m_Entries.resize(index + 1);
+            }
+
+            m_Entries[index] = Entry{
+                .m_Instance = instance,
+                .m_Destroy = &DestroyObject<T>,
+                .m_Block = block,
+            #if defined(HELENA_DEBUG)
+                .m_Key = Hash<std::uint64_t>::template Get<T>()
+            #endif
+            };
+        }
+
+        template <typename... T>
+        [[nodiscard]] bool Has() const
+        {
+            static_assert(!Traits::Arguments<T...>::Orphan, "Pack is empty!");
+            static_assert(((Traits::SameAS<T, Traits::RemoveCVRP<T>>) && ...), "Type is const/ptr/ref");
+
+            if constexpr(Traits::Arguments<T...>::Single) {
+                const auto index = m_TypeIndexer.template Get<T...>();
+                return index < m_Entries.size() && m_Entries[index].m_Instance;
+            } else {
+                return (Has<T>() && ...);
+            }
+        }
+
+        template <typename... T>
+        [[nodiscard]] bool Any() const
+        {
+            static_assert(Traits::Arguments<T...>::Size > 1, "Exclusion-only Type are not supported");
+            static_assert(((Traits::SameAS<T, Traits::RemoveCVRP<T>>) && ...), "Type is const/ptr/ref");
+
+            return (Has<T>() || ...);
+        }
+
+        template <typename... T>
+        [[nodiscard]] decltype(auto) Get()
+        {
+            static_assert(!Traits::Arguments<T...>::Orphan, "Pack is empty!");
+            static_assert(((Traits::SameAS<T, Traits::RemoveCVRP<T>>) && ...), "Type is const/ptr/ref");
+
+            if constexpr(Traits::Arguments<T...>::Single) {
+                const auto index = m_TypeIndexer.template Get<T...>();
+
+                HELENA_ASSERT(index < m_Entries.size() && m_Entries[index].m_Instance, "Type: {} not exist!", Traits::NameOf<T...>{});
+                HELENA_ASSERT(m_Entries[index].m_Key == Hash<std::uint64_t>::template Get<T...>(), "Type: {} type mismatch!", Traits::NameOf<T...>{});
+
+                using Type = typename Traits::Arguments<T...>::template Get<0>;
+                return *static_cast<Type*>(m_Entries[index].m_Instance);
+            } else {
+                return std::forward_as_tuple(Get<T>()...);
+            }
+        }
+
+        template <typename... T>
+        [[nodiscard]] decltype(auto) Get() const
+        {
+            static_assert(!Traits::Arguments<T...>::Orphan, "Pack is empty!");
+            static_assert(((Traits::SameAS<T, Traits::RemoveCVRP<T>>) && ...), "Type is const/ptr/ref");
+
+            if constexpr(Traits::Arguments<T...>::Single) {
+                const auto index = m_TypeIndexer.template Get<T...>();
+
+                HELENA_ASSERT(index < m_Entries.size() && m_Entries[index].m_Instance, "Type: {} not exist!", Traits::NameOf<T...>{});
+                HELENA_ASSERT(m_Entries[index].m_Key == Hash<std::uint64_t>::template Get<T...>(), "Type: {} type mismatch!", Traits::NameOf<T...>{});
+
+                using Type = typename Traits::Arguments<T...>::template Get<0>;
+                return *static_cast<const Type*>(m_Entries[index].m_Instance);
+            } else {
+                return std::forward_as_tuple(Get<T>()...);
+            }
+        }
+
+        template <typename... T>
+        void Remove()
+        {
+            static_assert(!Traits::Arguments<T...>::Orphan, "Pack is empty!");
+            static_assert(((Traits::SameAS<T, Traits::RemoveCVRP<T>>) && ...), "Type is const/ptr/ref");
+
+            if constexpr(Traits::Arguments<T...>::Single) {
+                const auto index = m_TypeIndexer.template Get<T...>();
+                HELENA_ASSERT(index < m_Entries.size() && m_Entries[index].m_Instance, "Type: {} not exist!", Traits::NameOf<T...>{});
+
+                // Same as VectorAny: removing the missing type does nothing
+                if(index < m_Entries.size() && m_Entries[index].m_Instance) {
+                    Destroy(m_Entries[index]);
+                }
+            } else {
+                (Remove<T>(), ...);
+            }
+        }
+
+        /**
+        * @brief Destroy all objects, the chunks are kept for the next objects
+        */
+        void Clear() noexcept
+        {
+            // Destructors can remove other objects: the entry is reset before the call
+            for(std::size_t index = 0; index < m_Entries.size(); ++index) {
+                if(m_Entries[index].m_Instance) {
+                    Destroy(m_Entries[index]);
+                }
+            }
+
+            // Objects created by the destructors keep their memory
+            const auto empty = std::none_of(m_Entries.cbegin(), m_Entries.cend(), [](const auto& entry) {
+                return entry.m_Instance;
+            });
+
+            if(empty) {
+                for(auto& chunk : m_Chunks) {
+                    chunk.m_Offset = 0;
+                }
+
+                m_Free.clear();
+            }
+        }
+
+        /**
+        * @brief Returns the total size of the chunks in bytes
+        */
+        [[nodiscard]] std::size_t Capacity() const noexcept
+        {
+            std::size_t size{};
+            for(const auto& chunk : m_Chunks) {
+                size += chunk.m_Size;
+            }
+
+            return size;
+        }
+
+    private:
+        Chunk& AddChunk(std::size_t size)
+        {
+            size = AlignUp((std::max)(size, ChunkSize), Traits::Cacheline);
+            return m_Chunks.emplace_back(Chunk{
+                .m_Data = std::unique_ptr<std::byte, ChunkDeleter>{static_cast<std::byte*>(::operator new(size, Alignment))},
+                .m_Size = size,
+                .m_Offset = 0
+            });
+        }
+
+        [[nodiscard]] Block Allocate(std::size_t size, std::size_t align)
+        {
+            // Blocks of the removed objects
+            const auto it = std::find_if(m_Free.begin(), m_Free.end(), [size, align](const auto& block) {
+                return block.m_Size >= size && !(reinterpret_cast<std::uintptr_t>(block.m_Data) % align);
+            });
+
+            if(it != m_Free.end()) {
+                const auto block = *it;
+                m_Free.erase(it);
+                return block;
+            }
+
+            const auto fnBump = [size, align](Chunk& chunk) -> std::byte* {
+                const auto address = reinterpret_cast<std::uintptr_t>(chunk.m_Data.get());
+                const auto offset = AlignUp(address + chunk.m_Offset, align) - address;
+                if(offset + size > chunk.m_Size) {
+                    return nullptr;
+                }
+
+                chunk.m_Offset = offset + size;
+                return chunk.m_Data.get() + offset;
+            };
+
+            for(auto& chunk : m_Chunks) {
+                if(auto* data = fnBump(chunk)) {
+                    return Block{data, size};
+                }
+            }
+
+            return Block{fnBump(AddChunk(size + align - Traits::Cacheline)), size};
+        }
+
+        void Destroy(Entry& entry) noexcept
+        {
+            const auto removed = std::exchange(entry, Entry{});
+            if(!removed.m_Instance) {
+                return;
+            }
+
+            removed.m_Destroy(removed.m_Instance);
+            m_Free.emplace_back(removed.m_Block);
+        }
+
+    private:
+        Types::UniqueIndexer<UniqueKey> m_TypeIndexer;
+        std::vector<Entry> m_Entries;
+        std::vector<Chunk> m_Chunks;
+        std::vector<Block> m_Free;
+    };
+}
+
+#endif // HELENA_TYPES_VECTORARENA_HPP
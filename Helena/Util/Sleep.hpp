@@ -1,9 +1,17 @@
 #ifndef HELENA_UTIL_SLEEP_HPP
 #define HELENA_UTIL_SLEEP_HPP
 
+#include <Helena/Platform/Platform.hpp>
+
+#include <cerrno>
 #include <cstdint>
 #include <chrono>
 #include <thread>
+#include <type_traits>
+
+#if defined(HELENA_PLATFORM_LINUX)
+    #include <time.h>
+#endif
 
 namespace Helena::Util
 {
@@ -15,6 +23,32 @@ namespace Helena::Util
     void Sleep(const std::chrono::duration<Rep, Period>& time) {
         std::this_thread::sleep_for(time);
     }
+
+    /**
+    * @brief Sleep until the absolute time point
+    * @param time Time point
+    * @note On Linux steady_clock is CLOCK_MONOTONIC, so clock_nanosleep(TIMER_ABSTIME) is used
+    * It does not accumulate the error of relative sleeps and is not affected by wall clock jumps
+    */
+    template <typename Clock, typename Duration>
+    void SleepUntil(const std::chrono::time_point<Clock, Duration>& time)
+    {
+    #if defined(HELENA_PLATFORM_LINUX)
+        if constexpr(std::is_same_v<Clock, std::chrono::steady_clock>) {
+            const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+            const timespec ts {
+                .tv_sec = static_cast<time_t>(ns / 1'000'000'000),
+                .tv_nsec = static_cast<long>(ns % 1'000'000'000)
+            };
+
+            while(clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {}
+        } else {
+            std::this_thread::sleep_until(time);
+        }
+    #else
+        std::this_thread::sleep_until(time);
+    #endif
+    }
 }
 
-#endif // HELENA_CORE_UTIL_SLEEP_HPP
\ No newline at end of file
+#endif // HELENA_CORE_UTIL_SLEEP_HPP